@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+    BandSplitter.h
+    Created: 19 Oct 2026 9:12:37pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+
+/**
+    Splits a buffer into 2-4 bands with 4th order Linkwitz-Riley crossovers
+    that sum back to an allpass, so the bands can be processed separately and
+    just added up again.
+
+    The crossovers run low to high: each one takes the high side of the one
+    before. The lower bands then go through a matching allpass for every
+    crossover above them, which lines their phase up with the bands that did
+    pass through those crossovers. The filters are the same TPT state variable
+    structure as juce::dsp::LinkwitzRileyFilter.
+
+    The channels run side by side, one per lane of a dsp::SIMDRegister, so a
+    stereo pair costs about what one channel does. Each group of channels goes
+    through in short chunks, interleaved into aligned scratch on the stack on
+    the way in and back out into the band buffers after.
+
+    When the channels fill no more than half the lanes and there are two or
+    three bands, the idle half carries work of its own instead of silence.
+    The same crossover's high and low sections run at once, one per half,
+    and so do the next crossover's first section and the low band's
+    compensating allpass. That takes three bands from seven sections in a row
+    to four. The middle band is then the second crossover's allpass minus its
+    high side, which is what its low side sums to, rather than that low
+    side's own two sections.
+
+    prepare() allocates; setCrossovers() and process() don't.
+*/
+class BandSplitter
+{
+public:
+    static constexpr int maxBands = 4;
+    static constexpr int maxCrossovers = maxBands - 1;
+
+    void prepare(int numChannels, double sr)
+    {
+        sampleRate = sr;
+        state.assign(static_cast<size_t>((numChannels + lanes - 1) / lanes), GroupState());
+        coeffsFor = {};
+    }
+
+    void reset() { std::fill(state.begin(), state.end(), GroupState()); }
+
+    /** audio thread. sorted and clamped here, so any order the user typed in is fine. */
+    void setCrossovers(std::array<float, maxCrossovers> freqs) noexcept
+    {
+        std::sort(freqs.begin(), freqs.end());
+        if (freqs == coeffsFor) return;
+
+        coeffsFor = freqs;
+        const float nyquistish = static_cast<float>(sampleRate * 0.45);
+
+        for (int x = 0; x < maxCrossovers; ++x)
+        {
+            const float fc = jlimit(10.0f, nyquistish, freqs[static_cast<size_t>(x)]);
+            const float g = static_cast<float>(std::tan(MathConstants<double>::pi * fc / sampleRate));
+            coeffs[static_cast<size_t>(x)] = { g, 1.0f / (1.0f + root2 * g + g * g) };
+        }
+    }
+
+    /** writes numBands bands of in's first numChannels channels into bands[0..numBands-1]. */
+    void process(const AudioBuffer<float>& in, std::array<AudioBuffer<float>, maxBands>& bands, int numBands) noexcept
+    {
+        const int numChannels = jmin(in.getNumChannels(), static_cast<int>(state.size()) * lanes);
+        const int n = in.getNumSamples();
+        const int numCrossovers = numBands - 1;
+
+        alignas(Vec::SIMDRegisterSize) float src[chunkSize * lanes];
+        alignas(Vec::SIMDRegisterSize) Scratch dst;
+
+        // the packed kernel reads the channels from both halves and leaves the low band in the upper one
+        const bool packed = (numCrossovers == 1 || numCrossovers == 2) && numChannels <= half;
+        const int perGroup = packed ? half : lanes;
+
+        for (int first = 0; first < numChannels; first += perGroup)
+        {
+            GroupState& st = state[static_cast<size_t>(first / perGroup)];
+            const int numLanes = jmin(perGroup, numChannels - first);
+
+            // lanes past the last channel filter silence
+            std::fill(std::begin(src), std::end(src), 0.0f);
+
+            for (int start = 0; start < n; start += chunkSize)
+            {
+                const int len = jmin(chunkSize, n - start);
+
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    const float* s = in.getReadPointer(first + lane, start);
+                    for (int i = 0; i < len; ++i) src[i * lanes + lane] = s[i];
+
+                    if (packed)
+                        for (int i = 0; i < len; ++i) src[i * lanes + half + lane] = s[i];
+                }
+
+                if (packed) splitPacked(st.packed, src, dst, len, numCrossovers);
+                else        splitLanes(st, src, dst, len, numCrossovers);
+
+                for (int b = 0; b < numBands; ++b)
+                {
+                    const int offset = packed && b == 0 ? half : 0;
+
+                    for (int lane = 0; lane < numLanes; ++lane)
+                    {
+                        float* d = bands[static_cast<size_t>(b)].getWritePointer(first + lane, start);
+                        for (int i = 0; i < len; ++i) d[i] = dst[b][i * lanes + offset + lane];
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    using Vec = dsp::SIMDRegister<float>;
+    static constexpr int lanes = static_cast<int>(Vec::SIMDNumElements);
+    static constexpr int half = lanes / 2;
+    static constexpr int chunkSize = 64;
+
+    static constexpr float root2 = 1.41421356237f;
+
+    struct Coeffs { float g = 0, h = 0; };
+
+    struct SplitState { Vec s1 {}, s2 {}, lo1 {}, lo2 {}, hi1 {}, hi2 {}; };
+    struct AllpassState { Vec s1 {}, s2 {}; };
+
+    // the first crossover's first section, its high | low sections, the second crossover's
+    // first section | the low band's allpass, and the second crossover's high section
+    struct PackedState { AllpassState first, split, next, high; };
+
+    struct GroupState
+    {
+        std::array<SplitState, maxCrossovers> split;
+        std::array<std::array<AllpassState, maxCrossovers>, maxCrossovers> comp; // [band][crossover above it]
+        PackedState packed;
+    };
+
+    using Scratch = float[maxBands][chunkSize * lanes];
+
+    /** one channel per lane, every section in turn. */
+    void splitLanes(GroupState& st, const float* src, Scratch& dst, int len, int numCrossovers) const noexcept
+    {
+        for (int i = 0; i < len; ++i)
+        {
+            Vec x = Vec::fromRawArray(src + i * lanes);
+
+            for (int c = 0; c < numCrossovers; ++c)
+            {
+                Vec low, high;
+                split(coeffs[static_cast<size_t>(c)], st.split[static_cast<size_t>(c)], x, low, high);
+
+                // the allpasses of every crossover above this band
+                for (int above = c + 1; above < numCrossovers; ++above)
+                    low = allpass(coeffs[static_cast<size_t>(above)], st.comp[static_cast<size_t>(c)][static_cast<size_t>(above)], low);
+
+                low.copyToRawArray(dst[c] + i * lanes);
+                x = high;
+            }
+
+            x.copyToRawArray(dst[numCrossovers] + i * lanes);
+        }
+    }
+
+    /** each channel in both halves, with the sections that don't depend on each other
+        side by side. the bands come out in the lower half but for band 0 in the upper. */
+    void splitPacked(PackedState& st, const float* src, Scratch& dst, int len, int numCrossovers) const noexcept
+    {
+        alignas(Vec::SIMDRegisterSize) float lowerHalf[lanes] = {}, upperHalf[lanes] = {};
+        for (int lane = 0; lane < half; ++lane) lowerHalf[lane] = upperHalf[half + lane] = 1.0f;
+        const Vec lower = Vec::fromRawArray(lowerHalf), upper = Vec::fromRawArray(upperHalf);
+
+        const Coeffs& k0 = coeffs[0];
+        const Coeffs& k1 = coeffs[1];
+
+        for (int i = 0; i < len; ++i)
+        {
+            Vec hp, bp, lp;
+            svf(k0, st.first.s1, st.first.s2, Vec::fromRawArray(src + i * lanes), hp, bp, lp);
+
+            // [high | low] of the first crossover
+            svf(k0, st.split.s1, st.split.s2, hp * lower + lp * upper, hp, bp, lp);
+            const Vec split0 = hp * lower + lp * upper;
+
+            if (numCrossovers == 1)
+            {
+                split0.copyToRawArray(dst[0] + i * lanes);
+                split0.copyToRawArray(dst[1] + i * lanes);
+                continue;
+            }
+
+            // [the second crossover's allpass | band 0 through its allpass], then the high side
+            svf(k1, st.next.s1, st.next.s2, split0, hp, bp, lp);
+            const Vec all = lp - bp * root2 + hp;
+
+            Vec high, b2, l2;
+            svf(k1, st.high.s1, st.high.s2, hp, high, b2, l2);
+
+            all.copyToRawArray(dst[0] + i * lanes);
+            (all - high).copyToRawArray(dst[1] + i * lanes);
+            high.copyToRawArray(dst[2] + i * lanes);
+        }
+    }
+
+    // one butterworth svf section: returns the highpass, band and lowpass outputs through the refs.
+    // a register only multiplies by a scalar on its right, hence the order
+    static void svf(const Coeffs& k, Vec& s1, Vec& s2, Vec x, Vec& hp, Vec& bp, Vec& lp) noexcept
+    {
+        hp = (x - s1 * (root2 + k.g) - s2) * k.h;
+        bp = hp * k.g + s1;
+        s1 = hp * k.g + bp;
+        lp = bp * k.g + s2;
+        s2 = bp * k.g + lp;
+    }
+
+    // lr4 low = butterworth lowpass twice, high = butterworth highpass twice; they sum to allpass()
+    static void split(const Coeffs& k, SplitState& s, Vec x, Vec& low, Vec& high) noexcept
+    {
+        Vec hp, bp, lp, h2, b2, l2;
+        svf(k, s.s1, s.s2, x, hp, bp, lp);
+        svf(k, s.lo1, s.lo2, lp, h2, b2, low);
+        svf(k, s.hi1, s.hi2, hp, high, b2, l2);
+    }
+
+    static Vec allpass(const Coeffs& k, AllpassState& s, Vec x) noexcept
+    {
+        Vec hp, bp, lp;
+        svf(k, s.s1, s.s2, x, hp, bp, lp);
+        return lp - bp * root2 + hp;
+    }
+
+    double sampleRate = 44100;
+    std::array<Coeffs, maxCrossovers> coeffs {};
+    std::array<float, maxCrossovers> coeffsFor {};
+    std::vector<GroupState> state;
+};
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    BitDelay.h
+    Created: 19 Oct 2026 5:34:47pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+#include "TransformTable.h"
+
+
+/**
+    Combines each integer sample with one D samples back, either the delayed
+    input (x[n] op x[n-D]) or the delayed output (x[n] op y[n-D], i.e. feedback
+    through the transform table).
+
+    One ring per channel, allocated in prepare() and sized to a power of two so
+    wrapping is a mask at chunk boundaries rather than a modulo per sample. The
+    inner loops only ever see contiguous runs.
+*/
+class BitDelay
+{
+public:
+    enum class Op { off = 0, xorOp, andOp, orOp };
+
+    static constexpr double maxDelaySeconds = 2.0;
+
+    void prepare(int numChannels, int maxBlockSize, double sampleRate)
+    {
+        maxDelay = jmax(1, roundToInt(maxDelaySeconds * sampleRate));
+        maxBlock = jmax(1, maxBlockSize);
+        size = nextPowerOfTwo(maxDelay + maxBlock);
+        mask = size - 1;
+
+        rings.assign(static_cast<size_t>(jmax(0, numChannels)), std::vector<BitWord>(static_cast<size_t>(size), 0));
+        writePos = 0;
+    }
+
+    int getMaxDelay() const { return maxDelay; }
+
+    /** call for every channel with the same n, then advance(n) once. */
+    void process(int chan, BitWord* data, int n, int delay, Op op, bool feedback, const TransformTable& table) noexcept
+    {
+        jassert(isPositiveAndBelow(chan, static_cast<int>(rings.size())));
+        delay = jlimit(1, maxDelay, delay);
+
+        // more than maxBlock at once would overwrite samples we still need to read
+        for (int done = 0; done < n; done += maxBlock)
+        {
+            const int len = jmin(maxBlock, n - done);
+            const int w = (writePos + done) & mask;
+
+            if (feedback) processFeedback(rings[static_cast<size_t>(chan)].data(), data + done, len, w, delay, op, table);
+            else          processInput(rings[static_cast<size_t>(chan)].data(), data + done, len, w, delay, op, table);
+        }
+    }
+
+    void advance(int n) noexcept { writePos = (writePos + n) & mask; }
+
+private:
+    void processInput(BitWord* ring, BitWord* data, int n, int w, int delay, Op op, const TransformTable& table) const noexcept
+    {
+        // no dependency on the output, so the raw input can go in first and
+        // the whole block is combined in at most two contiguous runs, even when
+        // the delay is shorter than the block
+        copyIntoRing(ring, w, data, n);
+
+        for (int done = 0; done < n;)
+        {
+            const int r = (w + done - delay) & mask;
+            const int len = jmin(n - done, size - r);
+            combine(data + done, ring + r, len, op);
+            done += len;
+        }
+
+        table.process(data, n);
+    }
+
+    void processFeedback(BitWord* ring, BitWord* data, int n, int w, int delay, Op op, const TransformTable& table) const noexcept
+    {
+        // each chunk may only read output that's already been written, so
+        // chunks are capped at the delay length. short delays degrade towards
+        // scalar, which is inherent to the recurrence.
+        for (int done = 0; done < n;)
+        {
+            const int r = (w + done - delay) & mask;
+            const int wp = (w + done) & mask;
+            const int len = jmin(n - done, delay, jmin(size - r, size - wp));
+
+            combine(data + done, ring + r, len, op);
+            table.process(data + done, len);
+            std::copy(data + done, data + done + len, ring + wp);
+            done += len;
+        }
+    }
+
+    void copyIntoRing(BitWord* ring, int w, const BitWord* data, int n) const noexcept
+    {
+        const int first = jmin(n, size - w);
+        std::copy(data, data + first, ring + w);
+        std::copy(data + first, data + n, ring);
+    }
+
+    static void combine(BitWord* __restrict d, const BitWord* __restrict r, int n, Op op) noexcept
+    {
+        switch (op)
+        {
+            case Op::xorOp: for (int i = 0; i < n; ++i) d[i] = static_cast<BitWord>(d[i] ^ r[i]); break;
+            case Op::andOp: for (int i = 0; i < n; ++i) d[i] = static_cast<BitWord>(d[i] & r[i]); break;
+            case Op::orOp:  for (int i = 0; i < n; ++i) d[i] = static_cast<BitWord>(d[i] | r[i]); break;
+            case Op::off:   break;
+        }
+    }
+
+    std::vector<std::vector<BitWord>> rings;
+    int maxDelay = 1, maxBlock = 1, size = 0, mask = 0;
+    int writePos = 0;
+};
@@ -0,0 +1,413 @@
+/*
+  ==============================================================================
+
+    BitExpression.cpp
+    Created: 19 Oct 2026 4:40:12pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include "BitExpression.h"
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+
+
+//==============================================================================
+class BitExpression::Parser
+{
+public:
+    Parser (const std::string& s, std::vector<Node>& n) : src(s), nodes(n) {}
+
+    int parseAll()
+    {
+        int r = ternary();
+        skip();
+        if (pos != src.size()) fail ("unexpected '" + std::string(1, src[pos]) + "'");
+        return r;
+    }
+
+    String error;
+
+private:
+    struct ParseError {};
+
+    // expressions come out of saved sessions too, so a hostile one mustn't be
+    // able to run the stack out or make the table take forever to build
+    static constexpr int maxDepth = 256;
+    static constexpr size_t maxNodes = 1024;
+
+    const std::string& src;
+    std::vector<Node>& nodes;
+    size_t pos = 0;
+    int depth = 0;
+
+    [[noreturn]] void fail (const std::string& msg)
+    {
+        error = String(msg) + " at column " + String(static_cast<int>(pos) + 1);
+        throw ParseError();
+    }
+
+    int add (Op op, int a = -1, int b = -1, int c = -1, int64 value = 0)
+    {
+        if (nodes.size() >= maxNodes) fail ("expression too long");
+        nodes.push_back({op, value, a, b, c});
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    void skip() { while (pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos]))) ++pos; }
+
+    bool accept (const char* tok)
+    {
+        skip();
+        size_t len = std::strlen(tok);
+        if (src.compare(pos, len, tok) != 0) return false;
+
+        // don't let "<" eat the first half of "<<", "&" of "&&", etc.
+        if (len == 1 && pos + 1 < src.size())
+        {
+            char n = src[pos + 1];
+            char c = tok[0];
+            if ((c == '<' || c == '>') && (n == c || n == '=')) return false;
+            if ((c == '&' || c == '|') && n == c) return false;
+            if ((c == '!' || c == '=') && n == '=') return false;
+        }
+
+        pos += len;
+        return true;
+    }
+
+    void expect (const char* tok) { if (! accept(tok)) fail (std::string("expected '") + tok + "'"); }
+
+    int ternary()
+    {
+        int cond = logicalOr();
+        if (! accept("?")) return cond;
+        int a = ternary();
+        expect(":");
+        int b = ternary();
+        return add(Op::select, cond, a, b);
+    }
+
+    int logicalOr()
+    {
+        int l = logicalAnd();
+        while (accept("||")) l = add(Op::logicalOr, l, logicalAnd());
+        return l;
+    }
+
+    int logicalAnd()
+    {
+        int l = bitOr();
+        while (accept("&&")) l = add(Op::logicalAnd, l, bitOr());
+        return l;
+    }
+
+    int bitOr()
+    {
+        int l = bitXor();
+        while (accept("|")) l = add(Op::bitOr, l, bitXor());
+        return l;
+    }
+
+    int bitXor()
+    {
+        int l = bitAnd();
+        while (accept("^")) l = add(Op::bitXor, l, bitAnd());
+        return l;
+    }
+
+    int bitAnd()
+    {
+        int l = equality();
+        while (accept("&")) l = add(Op::bitAnd, l, equality());
+        return l;
+    }
+
+    int equality()
+    {
+        int l = relational();
+        for (;;)
+        {
+            if      (accept("==")) l = add(Op::eq, l, relational());
+            else if (accept("!=")) l = add(Op::ne, l, relational());
+            else return l;
+        }
+    }
+
+    int relational()
+    {
+        int l = shift();
+        for (;;)
+        {
+            if      (accept("<=")) l = add(Op::le, l, shift());
+            else if (accept(">=")) l = add(Op::ge, l, shift());
+            else if (accept("<"))  l = add(Op::lt, l, shift());
+            else if (accept(">"))  l = add(Op::gt, l, shift());
+            else return l;
+        }
+    }
+
+    int shift()
+    {
+        int l = additive();
+        for (;;)
+        {
+            if      (accept("<<")) l = add(Op::shl, l, additive());
+            else if (accept(">>")) l = add(Op::shr, l, additive());
+            else return l;
+        }
+    }
+
+    int additive()
+    {
+        int l = multiplicative();
+        for (;;)
+        {
+            if      (accept("+")) l = add(Op::add, l, multiplicative());
+            else if (accept("-")) l = add(Op::sub, l, multiplicative());
+            else return l;
+        }
+    }
+
+    int multiplicative()
+    {
+        int l = unary();
+        for (;;)
+        {
+            if      (accept("*")) l = add(Op::mul, l, unary());
+            else if (accept("/")) l = add(Op::div, l, unary());
+            else if (accept("%")) l = add(Op::mod, l, unary());
+            else return l;
+        }
+    }
+
+    int unary()
+    {
+        // every kind of nesting comes back through here
+        if (++depth > maxDepth) fail ("nested too deeply");
+
+        int r;
+        if      (accept("~")) r = add(Op::bitNot, unary());
+        else if (accept("!")) r = add(Op::logicalNot, unary());
+        else if (accept("-")) r = add(Op::negate, unary());
+        else if (accept("+")) r = unary();
+        else r = primary();
+
+        --depth;
+        return r;
+    }
+
+    int primary()
+    {
+        skip();
+        if (pos >= src.size()) fail ("unexpected end of expression");
+
+        if (accept("("))
+        {
+            int r = ternary();
+            expect(")");
+            return r;
+        }
+
+        char c = src[pos];
+
+        if (std::isdigit(static_cast<unsigned char>(c))) return number();
+
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_')
+        {
+            size_t start = pos;
+            while (pos < src.size() && (std::isalnum(static_cast<unsigned char>(src[pos])) || src[pos] == '_')) ++pos;
+            std::string name = src.substr(start, pos - start);
+
+            if (name == "x") return add(Op::input);
+
+            struct Fn { const char* name; Op op; int nargs; };
+            static const Fn fns[] = {
+                {"rotl", Op::rotl, 2}, {"rotr", Op::rotr, 2},
+                {"gray", Op::gray, 1}, {"ungray", Op::ungray, 1},
+                {"bitreverse", Op::bitreverse, 1}, {"popcount", Op::popcount, 1},
+                {"bit", Op::bit, 2}, {"abs", Op::abs, 1},
+                {"min", Op::min, 2}, {"max", Op::max, 2}
+            };
+
+            for (const Fn& f : fns)
+            {
+                if (name != f.name) continue;
+
+                expect("(");
+                int a = ternary();
+                int b = -1;
+                if (f.nargs == 2) { expect(","); b = ternary(); }
+                expect(")");
+                return add(f.op, a, b);
+            }
+
+            pos = start;
+            fail ("unknown identifier '" + name + "'");
+        }
+
+        fail (std::string("unexpected '") + c + "'");
+    }
+
+    int number()
+    {
+        int base = 10;
+        if (src[pos] == '0' && pos + 1 < src.size())
+        {
+            char p = static_cast<char>(std::tolower(static_cast<unsigned char>(src[pos + 1])));
+            if (p == 'x') { base = 16; pos += 2; }
+            else if (p == 'b') { base = 2; pos += 2; }
+        }
+
+        uint64 v = 0;
+        size_t start = pos;
+        for (; pos < src.size(); ++pos)
+        {
+            int d = std::tolower(static_cast<unsigned char>(src[pos]));
+            int digit = std::isdigit(d) ? d - '0' : (d >= 'a' && d <= 'f') ? d - 'a' + 10 : 99;
+            if (digit >= base) break;
+            if (v > (std::numeric_limits<uint64>::max() - static_cast<uint64>(digit)) / static_cast<uint64>(base)) fail ("literal too large");
+            v = v * static_cast<uint64>(base) + static_cast<uint64>(digit);
+        }
+
+        if (pos == start) fail ("malformed literal");
+        return add(Op::constant, -1, -1, -1, static_cast<int64>(v));
+    }
+};
+
+
+//==============================================================================
+BitExpression::BitExpression() {}
+
+Result BitExpression::parse (const String& newText, int bitsInWord)
+{
+    jassert(bitsInWord > 0 && bitsInWord < 64);
+
+    std::string s = newText.trim().toStdString();
+
+    std::vector<Node> newNodes;
+    int newRoot = -1;
+
+    if (! s.empty())
+    {
+        Parser p(s, newNodes);
+        try
+        {
+            newRoot = p.parseAll();
+        }
+        catch (...)
+        {
+            return Result::fail(p.error);
+        }
+    }
+
+    nodes = std::move(newNodes);
+    root = newRoot;
+    numBits = bitsInWord;
+    mask = (uint64(1) << numBits) - 1;
+    text = newText.trim();
+
+    // a lone "x" is the same as no expression at all
+    if (root >= 0 && nodes[static_cast<size_t>(root)].op == Op::input) root = -1;
+
+    return Result::ok();
+}
+
+int64 BitExpression::evaluate (int64 x) const
+{
+    x = wrap(x);
+    return root < 0 ? x : wrap(eval(root, x));
+}
+
+int64 BitExpression::wrap (int64 v) const
+{
+    uint64 u = bits(v);
+    uint64 sign = uint64(1) << (numBits - 1);
+    return static_cast<int64>((u ^ sign) - sign);
+}
+
+int64 BitExpression::eval (int idx, int64 x) const
+{
+    const Node& n = nodes[static_cast<size_t>(idx)];
+
+    auto A = [&] { return eval(n.a, x); };
+    auto B = [&] { return eval(n.b, x); };
+    auto shiftAmount = [] (int64 s) { return static_cast<int>(jlimit<int64>(0, 63, s)); };
+
+    switch (n.op)
+    {
+        case Op::constant:   return n.value;
+        case Op::input:      return x;
+
+        case Op::negate:     return static_cast<int64>(0 - static_cast<uint64>(A()));
+        case Op::bitNot:     return ~A();
+        case Op::logicalNot: return A() == 0;
+
+        case Op::mul:        return static_cast<int64>(static_cast<uint64>(A()) * static_cast<uint64>(B()));
+        case Op::div:        { int64 a = A(), b = B(); return (b == 0 || (b == -1 && a == std::numeric_limits<int64>::min())) ? 0 : a / b; }
+        case Op::mod:        { int64 a = A(), b = B(); return (b == 0 || b == -1) ? 0 : a % b; }
+        case Op::add:        return static_cast<int64>(static_cast<uint64>(A()) + static_cast<uint64>(B()));
+        case Op::sub:        return static_cast<int64>(static_cast<uint64>(A()) - static_cast<uint64>(B()));
+        case Op::shl:        { int64 a = A(); return static_cast<int64>(static_cast<uint64>(a) << shiftAmount(B())); }
+        case Op::shr:        { int64 a = A(); return a >> shiftAmount(B()); }
+
+        case Op::lt:         return A() <  B();
+        case Op::le:         return A() <= B();
+        case Op::gt:         return A() >  B();
+        case Op::ge:         return A() >= B();
+        case Op::eq:         return A() == B();
+        case Op::ne:         return A() != B();
+
+        case Op::bitAnd:     return A() & B();
+        case Op::bitXor:     return A() ^ B();
+        case Op::bitOr:      return A() | B();
+        case Op::logicalAnd: return A() != 0 && B() != 0;
+        case Op::logicalOr:  return A() != 0 || B() != 0;
+
+        case Op::select:     return A() != 0 ? B() : eval(n.c, x);
+
+        case Op::rotl:
+        case Op::rotr:
+        {
+            uint64 u = bits(A());
+            int s = static_cast<int>(((B() % numBits) + numBits) % numBits);
+            if (n.op == Op::rotr) s = (numBits - s) % numBits;
+            if (s == 0) return wrap(static_cast<int64>(u));
+            return wrap(static_cast<int64>(((u << s) | (u >> (numBits - s))) & mask));
+        }
+
+        case Op::gray:       { uint64 u = bits(A()); return wrap(static_cast<int64>(u ^ (u >> 1))); }
+        case Op::ungray:
+        {
+            uint64 u = bits(A());
+            for (uint64 s = u >> 1; s != 0; s >>= 1) u ^= s;
+            return wrap(static_cast<int64>(u));
+        }
+
+        case Op::bitreverse:
+        {
+            uint64 u = bits(A()), r = 0;
+            for (int i = 0; i < numBits; ++i) r |= ((u >> i) & 1) << (numBits - 1 - i);
+            return wrap(static_cast<int64>(r));
+        }
+
+        case Op::popcount:
+        {
+            uint64 u = bits(A());
+            int c = 0;
+            for (; u != 0; u &= u - 1) ++c;
+            return c;
+        }
+
+        case Op::bit:        { uint64 u = bits(A()); return static_cast<int64>((u >> shiftAmount(B())) & 1); }
+        case Op::abs:        { int64 a = A(); return a < 0 ? static_cast<int64>(0 - static_cast<uint64>(a)) : a; }
+        case Op::min:        return jmin(A(), B());
+        case Op::max:        return jmax(A(), B());
+    }
+
+    jassertfalse;
+    return 0;
+}
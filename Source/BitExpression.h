@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    BitExpression.h
+    Created: 19 Oct 2026 4:40:12pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <string>
+
+
+/**
+    A tiny C-like expression language over a single integer sample `x`.
+
+    Expressions are parsed on the message thread and then evaluated once for
+    every possible input word when the engine bakes its lookup table, so none
+    of this ever runs on the audio thread.
+
+    `x` is the sample as a signed numBits-wide integer. Supported:
+        literals     123, 0xFF0F, 0b1010
+        unary        ~ ! -
+        binary       * / % + - << >> < <= > >= == != & ^ | && ||
+        ternary      c ? a : b
+        functions    rotl(v,n) rotr(v,n) gray(v) ungray(v) bitreverse(v)
+                     popcount(v) bit(v,n) abs(v) min(a,b) max(a,b)
+
+    e.g. "rotl(x,3) ^ gray(x)", "bitreverse(x) & 0xFF0F", "x<0 ? ~x : x"
+*/
+class BitExpression
+{
+public:
+    BitExpression();
+
+    /** parses text; on failure the expression is left untouched. */
+    Result parse (const String& text, int numBits);
+
+    /** evaluates for one input. the result is sign-extended to numBits. */
+    int64 evaluate (int64 x) const;
+
+    bool isIdentity() const { return root < 0; }
+    String getText() const { return text; }
+
+private:
+    enum class Op : uint8
+    {
+        constant, input,
+        negate, bitNot, logicalNot,
+        mul, div, mod, add, sub, shl, shr,
+        lt, le, gt, ge, eq, ne,
+        bitAnd, bitXor, bitOr, logicalAnd, logicalOr,
+        select,
+        rotl, rotr, gray, ungray, bitreverse, popcount, bit, abs, min, max
+    };
+
+    struct Node
+    {
+        Op op;
+        int64 value;
+        int a, b, c;
+    };
+
+    class Parser;
+
+    int64 eval (int node, int64 x) const;
+    int64 wrap (int64 v) const;
+    uint64 bits (int64 v) const { return static_cast<uint64> (v) & mask; }
+
+    std::vector<Node> nodes;
+    int root = -1;
+    int numBits = 16;
+    uint64 mask = 0xffff;
+    String text;
+};
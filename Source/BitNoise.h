@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    BitNoise.h
+    Created: 19 Oct 2026 10:02:51pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "TransformTable.h"
+
+
+/**
+    Random bit flips in the integer domain: bit b of every sample flips with
+    its own probability.
+
+    Which samples flip is a pure function of the seed, channel, bit and
+    absolute sample position, so a render lines up with playback bit for bit
+    however either one is cut into blocks, and seeking lands on the same flips.
+    Time is split into frames of frameLength samples, and each bit's draws come
+    from a counter-based generator keyed on the frame.
+
+    A bit is drawn one of two ways depending on its probability. Below
+    denseAbove, it steps from one flip to the next by geometric gaps, so the
+    cost follows the number of flips and the rates that barely touch the
+    sound cost next to nothing. At or above it, every sample gets a 16 bit
+    hash that is compared against the bit's threshold. That runs in
+    chunk-sized loops the compiler vectorises, and costs the same at any rate.
+
+    prepare() allocates; the rest is for the audio thread.
+*/
+class BitNoise
+{
+public:
+    static constexpr int frameLength = 4096;
+
+    // where sixteen bits' worth of hashes per sample start to cost less than a hash
+    // and a log per flip; about 5 ns per sample either way in a release build
+    static constexpr double denseAbove = 0.015;
+
+    void prepare(int numChannels)
+    {
+        streams.assign(static_cast<size_t>(jmax(0, numChannels) * N_BITS), Stream());
+    }
+
+    /** cheap when nothing changed. */
+    void setProbabilities(const std::array<float, N_BITS>& p) noexcept
+    {
+        if (p == probabilities) return;
+
+        probabilities = p;
+        active = false;
+        anyDense = false;
+        for (int bit = 0; bit < N_BITS; ++bit)
+        {
+            const auto b = static_cast<size_t>(bit);
+            const double prob = jlimit(0.0, 1.0, static_cast<double>(p[b]));
+
+            draws[b] = prob <= 0 ? Draw::off : prob < denseAbove ? Draw::sparse : Draw::dense;
+
+            // one over the log of the odds a sample doesn't flip, for the gaps
+            gapScale[b] = draws[b] == Draw::sparse ? 1.0 / std::log1p(-prob) : 0.0;
+
+            // a hash at or below this flips, so 1 always flips
+            limits[b] = static_cast<uint16>(jlimit(0, 0xffff, roundToInt(prob * 65536.0) - 1));
+
+            active = active || draws[b] != Draw::off;
+            anyDense = anyDense || draws[b] == Draw::dense;
+        }
+    }
+
+    bool isActive() const noexcept { return active; }
+
+    /** xors the flips for samples [position, position + n) into data. */
+    void process(int chan, BitWord* data, int n, int64 position, uint64 seed) noexcept
+    {
+        if (! isPositiveAndBelow(chan * N_BITS, static_cast<int>(streams.size()))) return;
+
+        const int64 end = position + n;
+
+        for (int bit = 0; bit < N_BITS; ++bit)
+        {
+            if (draws[static_cast<size_t>(bit)] != Draw::sparse) continue;
+
+            const double r = gapScale[static_cast<size_t>(bit)];
+            Stream& s = streams[static_cast<size_t>(chan * N_BITS + bit)];
+            const uint64 key = keyFor(seed, chan, bit);
+
+            // anything but carrying on from the last block (a seek, a new seed,
+            // the bit just switched on) starts over from the frame's first flip
+            if (s.upTo != position || s.seed != seed)
+            {
+                startFrame(key, s, position / frameLength, r);
+                s.seed = seed;
+                settle(key, s, r);
+                while (s.next < position) step(key, s, r);
+            }
+
+            const BitWord b = static_cast<BitWord>(1u << bit);
+            while (s.next < end)
+            {
+                data[s.next - position] ^= b;
+                step(key, s, r);
+            }
+
+            s.upTo = end;
+        }
+
+        if (anyDense) processDense(chan, data, position, end, seed);
+    }
+
+private:
+    struct Stream
+    {
+        int64 frame = 0, next = 0, upTo = -1;
+        uint64 seed = 0, frameKey = 0;
+        uint32 draw = 0;
+    };
+
+    enum class Draw : uint8 { off, sparse, dense };
+
+    static constexpr int chunkSize = 64;
+
+    // splitmix64's finaliser
+    static uint64 mix(uint64 z) noexcept
+    {
+        z += 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    static uint64 keyFor(uint64 seed, int chan, int bit) noexcept
+    {
+        return mix(seed ^ (static_cast<uint64>(chan) << 8 | static_cast<uint64>(bit)));
+    }
+
+    // a two round 16 bit integer hash, kept to 16 bit lanes so it vectorises
+    static uint16 hash16(uint16 x) noexcept
+    {
+        x = static_cast<uint16>(x ^ (x >> 8));
+        x = static_cast<uint16>(x * 0x88b5u);
+        x = static_cast<uint16>(x ^ (x >> 7));
+        x = static_cast<uint16>(x * 0xdb2du);
+        return static_cast<uint16>(x ^ (x >> 9));
+    }
+
+    /** the dense bits, a chunk at a time. chunks never cross a frame, and each dense
+        bit hashes the chunk's scrambled offsets with its own key for the frame. */
+    void processDense(int chan, BitWord* data, int64 position, int64 end, uint64 seed) const noexcept
+    {
+        std::array<uint16, N_BITS> keys {};
+        int64 keyed = -1;
+
+        for (int64 start = position; start < end;)
+        {
+            const int64 frame = start / frameLength;
+            if (frame != keyed)
+            {
+                for (int bit = 0; bit < N_BITS; ++bit)
+                    if (draws[static_cast<size_t>(bit)] == Draw::dense)
+                        keys[static_cast<size_t>(bit)] = static_cast<uint16>(mix(keyFor(seed, chan, bit) ^ static_cast<uint64>(frame)));
+                keyed = frame;
+            }
+
+            const auto offset = static_cast<int>(start - frame * frameLength);
+            const auto len = static_cast<int>(jmin(static_cast<int64>(chunkSize), end - start,
+                                                   static_cast<int64>(frameLength - offset)));
+
+            // the offsets within the frame, scrambled once for every bit. the whole
+            // chunk is always worked out so the loops have a fixed length
+            alignas(16) uint16 where[chunkSize];
+            alignas(16) BitWord flips[chunkSize] = {};
+            for (int i = 0; i < chunkSize; ++i) where[i] = hash16(static_cast<uint16>(offset + i));
+
+            for (int bit = 0; bit < N_BITS; ++bit)
+            {
+                if (draws[static_cast<size_t>(bit)] != Draw::dense) continue;
+
+                const uint16 key = keys[static_cast<size_t>(bit)];
+                const uint16 limit = limits[static_cast<size_t>(bit)];
+                const auto b = static_cast<BitWord>(1u << bit);
+
+                for (int i = 0; i < chunkSize; ++i)
+                    flips[i] = static_cast<BitWord>(flips[i] | (hash16(static_cast<uint16>(where[i] ^ key)) <= limit ? b : 0));
+            }
+
+            BitWord* out = data + (start - position);
+            for (int i = 0; i < len; ++i) out[i] ^= flips[i];
+
+            start += len;
+        }
+    }
+
+    /** samples to skip before the next flip, geometric with the bit's probability. */
+    static int64 gap(Stream& s, double scale) noexcept
+    {
+        const uint64 h = mix(s.frameKey ^ s.draw++);
+        const double u = static_cast<double>((h >> 11) + 1) * 0x1.0p-53; // (0, 1]
+        return static_cast<int64>(jmin(static_cast<double>(frameLength), std::floor(std::log(u) * scale)));
+    }
+
+    static void startFrame(uint64 key, Stream& s, int64 frame, double scale) noexcept
+    {
+        s.frame = frame;
+        s.frameKey = mix(key ^ static_cast<uint64>(frame));
+        s.draw = 0;
+        s.next = frame * frameLength + gap(s, scale);
+    }
+
+    static void step(uint64 key, Stream& s, double scale) noexcept
+    {
+        s.next += 1 + gap(s, scale);
+        settle(key, s, scale);
+    }
+
+    // flips never run over a frame boundary, so every frame can be found from scratch
+    static void settle(uint64 key, Stream& s, double scale) noexcept
+    {
+        while (s.next >= (s.frame + 1) * frameLength)
+            startFrame(key, s, s.frame + 1, scale);
+    }
+
+    std::vector<Stream> streams;
+    std::array<float, N_BITS> probabilities {};
+    std::array<Draw, N_BITS> draws {};
+    std::array<double, N_BITS> gapScale {};
+    std::array<uint16, N_BITS> limits {};
+    bool active = false, anyDense = false;
+};
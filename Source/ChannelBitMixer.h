@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+    ChannelBitMixer.h
+    Created: 19 Oct 2026 6:12:18pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <bitset>
+#include <vector>
+
+#include "TransformTable.h"
+
+
+/**
+    Moves bit planes between channels. Every mode boils down to a matrix of
+    masks, where from[out][src] holds the bits output channel `out` takes from
+    input channel `src`; the rows of each output OR together to one word.
+
+        rotate      the selected bits of channel c come from channel c + offset
+        copy        the selected bits of every channel come from channel `offset`
+        interleave  selected bit b of channel c comes from channel c + b + offset
+
+    The kernel stays planar: each output is the OR of (in[src] & mask) over the
+    sources, which vectorises over samples without any shuffling. A stereo pair
+    goes in place in a single pass. Up to maxFrameChannels, a chunk of every
+    input is read once and every output of that chunk is worked out on the
+    stack before any of them is written back. Wider layouts accumulate one
+    output at a time from the sources that contribute, into scratch that's
+    copied back once every output is done.
+*/
+class ChannelBitMixer
+{
+public:
+    enum class Mode { off = 0, rotate, copy, interleave };
+
+    static constexpr int maxFrameChannels = 8;
+
+    void prepare(int numChannels, int maxBlockSize)
+    {
+        channels = jmax(0, numChannels);
+        scratch.assign(static_cast<size_t>(channels * jmax(1, maxBlockSize)), 0);
+        blockCapacity = jmax(1, maxBlockSize);
+        from.assign(static_cast<size_t>(channels * channels), 0);
+    }
+
+    /** data[c] are the integer channels, all n long. */
+    void process(BitWord* const* data, int numChannels, int n, Mode mode, std::bitset<N_BITS> bits, int offset) noexcept
+    {
+        numChannels = jmin(numChannels, channels);
+        if (mode == Mode::off || numChannels < 2 || bits.none()) return;
+
+        buildMatrix(numChannels, mode, static_cast<BitWord>(bits.to_ulong()), offset);
+
+        switch (numChannels)
+        {
+            case 2: mixPair(data[0], data[1], from[0], from[1], from[static_cast<size_t>(channels)], from[static_cast<size_t>(channels) + 1], n); return;
+            case 3: mixFrames<3>(data, n); return;
+            case 4: mixFrames<4>(data, n); return;
+            case 5: mixFrames<5>(data, n); return;
+            case 6: mixFrames<6>(data, n); return;
+            case 7: mixFrames<7>(data, n); return;
+            case 8: mixFrames<8>(data, n); return;
+            default: break;
+        }
+
+        for (int done = 0; done < n; done += blockCapacity)
+        {
+            const int len = jmin(blockCapacity, n - done);
+
+            for (int out = 0; out < numChannels; ++out)
+            {
+                BitWord* dst = scratch.data() + out * blockCapacity;
+                bool first = true;
+
+                for (int src = 0; src < numChannels; ++src)
+                {
+                    const BitWord m = from[static_cast<size_t>(out * channels + src)];
+                    if (m == 0) continue;
+
+                    if (first) takeBits(dst, data[src] + done, m, len);
+                    else addBits(dst, data[src] + done, m, len);
+                    first = false;
+                }
+
+                if (first) std::fill(dst, dst + len, BitWord(0));
+            }
+
+            // every output depends on every input, so nothing is written back until all are done
+            for (int out = 0; out < numChannels; ++out)
+            {
+                const BitWord* s = scratch.data() + out * blockCapacity;
+                std::copy(s, s + len, data[out] + done);
+            }
+        }
+    }
+
+private:
+    // out of line with restrict parameters, which is where compilers actually honour them
+    static void takeBits(BitWord* __restrict dst, const BitWord* __restrict in, BitWord m, int n) noexcept
+    {
+        for (int i = 0; i < n; ++i) dst[i] = static_cast<BitWord>(in[i] & m);
+    }
+
+    static void addBits(BitWord* __restrict dst, const BitWord* __restrict in, BitWord m, int n) noexcept
+    {
+        for (int i = 0; i < n; ++i) dst[i] = static_cast<BitWord>(dst[i] | (in[i] & m));
+    }
+
+    // both outputs of a pair only need that sample of both inputs, so it goes in place in one pass
+    static void mixPair(BitWord* __restrict l, BitWord* __restrict r, BitWord ll, BitWord lr, BitWord rl, BitWord rr, int n) noexcept
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const BitWord a = l[i], b = r[i];
+            l[i] = static_cast<BitWord>((a & ll) | (b & lr));
+            r[i] = static_cast<BitWord>((a & rl) | (b & rr));
+        }
+    }
+
+    static constexpr int frameChunk = 64;
+
+    /** N channels in chunks: each output of a chunk is the OR over every input, read
+        straight from the host, and lands on the stack. nothing is written back until
+        the whole chunk is done, since every output can depend on every input. */
+    template <size_t N>
+    void mixFrames(BitWord* const* data, int n) const noexcept
+    {
+        static_assert(N > 2 && N <= maxFrameChannels, "pairs and wide layouts have their own paths");
+
+        BitWord m[N][N];
+        for (size_t out = 0; out < N; ++out)
+            for (size_t src = 0; src < N; ++src)
+                m[out][src] = from[out * static_cast<size_t>(channels) + src];
+
+        for (int done = 0; done < n; done += frameChunk)
+        {
+            const int len = jmin(frameChunk, n - done);
+            alignas(16) BitWord mixed[N][frameChunk];
+
+            const BitWord* in[N];
+            for (size_t src = 0; src < N; ++src) in[src] = data[src] + done;
+
+            for (int i = 0; i < len; ++i)
+            {
+                for (size_t out = 0; out < N; ++out)
+                {
+                    BitWord acc = 0;
+                    for (size_t src = 0; src < N; ++src) acc = static_cast<BitWord>(acc | (in[src][i] & m[out][src]));
+                    mixed[out][i] = acc;
+                }
+            }
+
+            for (size_t out = 0; out < N; ++out) std::copy(mixed[out], mixed[out] + len, data[out] + done);
+        }
+    }
+
+    void buildMatrix(int numChannels, Mode mode, BitWord bits, int offset) noexcept
+    {
+        const BitWord keep = static_cast<BitWord>(~bits);
+        auto wrap = [numChannels] (int c) { return ((c % numChannels) + numChannels) % numChannels; };
+
+        std::fill(from.begin(), from.end(), BitWord(0));
+
+        for (int out = 0; out < numChannels; ++out)
+        {
+            BitWord* row = from.data() + out * channels;
+            row[out] = keep;
+
+            switch (mode)
+            {
+                case Mode::rotate:  row[wrap(out + offset)] |= bits; break;
+                case Mode::copy:    row[wrap(offset)] |= bits; break;
+                case Mode::interleave:
+                    for (int b = 0; b < N_BITS; ++b)
+                        if ((bits >> b) & 1)
+                            row[wrap(out + b + offset)] |= static_cast<BitWord>(1u << b);
+                    break;
+                case Mode::off: break;
+            }
+        }
+    }
+
+    std::vector<BitWord> scratch, from;
+    int channels = 0, blockCapacity = 1;
+};
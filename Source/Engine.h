@@ -14,72 +14,360 @@
 #include <array>
 #include <memory>
 #include <cmath>
+#include <vector>
+
+#ifndef N_BITS
+ #define N_BITS 16 // the plugin sets this in PluginProcessor.h; the tools get the same default
+#endif
+
+#include "BitExpression.h"
+#include "TransformTable.h"
+#include "TripleBuffer.h"
+#include "TableCache.h"
+#include "BandSplitter.h"
+#include "BitDelay.h"
+#include "BitNoise.h"
+#include "ChannelBitMixer.h"
+#include "FloatBits.h"
+#include "Trace.h"
 
 
 class BitmaskerEngine
 {
 public:
-    BitmaskerEngine() : removeDCOffset()
+    BitmaskerEngine()
     {
+        for (Band& b : bands)
+        {
 #if N_BITS == 8
-        andmask.store(std::bitset<8>("11111111"));
-        ormask.store(std::bitset<8>("00000000"));
-        xormask.store(std::bitset<8>("00000000"));
-        bitremap.store({0, 1, 2, 3, 4, 5, 6, 7});
+            b.andmask.store(std::bitset<8>("11111111"));
+            b.ormask.store(std::bitset<8>("00000000"));
+            b.xormask.store(std::bitset<8>("00000000"));
+            b.bitremap.store({0, 1, 2, 3, 4, 5, 6, 7});
 #elif N_BITS == 16
-        andmask.store(std::bitset<16>("1111111111111111"));
-        ormask.store(std::bitset<16>("0000000000000000"));
-        xormask.store(std::bitset<16>("0000000000000000"));
-        bitremap.store({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15});
+            b.andmask.store(std::bitset<16>("1111111111111111"));
+            b.ormask.store(std::bitset<16>("0000000000000000"));
+            b.xormask.store(std::bitset<16>("0000000000000000"));
+            b.bitremap.store({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15});
 #endif
+        }
+
+        for (auto& p : flipProbability) p.store(0.0f);
+        noiseSeed.store(1);
+        programChangeRemaps.store(false);
+
+        numBands.store(1);
+        crossoverFreqs[0].store(200.0f);
+        crossoverFreqs[1].store(2000.0f);
+        crossoverFreqs[2].store(8000.0f);
 
-        lastsamps.fill(0.0);
         entropyval.store(0.0);
 
         removedenormals.store(false);
 
-        for (int i = 0; i < 64; ++i)
-        {
-            removeDCOffset[i] = std::make_unique<dsp::IIR::Filter<double>>(dsp::IIR::Coefficients<double>::makeFirstOrderHighPass(44100, 1));
-        }
+        delayOp.store(BitDelay::Op::off);
+        delayFeedback.store(false);
+        delaySeconds.store(0.25);
+
+        crossMode.store(ChannelBitMixer::Mode::off);
+#if N_BITS == 8
+        crossMask.store(std::bitset<8>("11110000"));
+#elif N_BITS == 16
+        crossMask.store(std::bitset<16>("1111000000000000"));
+#endif
+        crossOffset.store(1);
+
+        floatMode.store(false);
+        floatandmask.store(std::bitset<32>().set());
+        floatormask.store(std::bitset<32>());
+        floatxormask.store(std::bitset<32>());
+        std::array<uint8, 32> identity;
+        for (uint8 i = 0; i < 32; ++i) identity[i] = i;
+        floatbitremap.store(identity);
+
+        // per-channel state, the delay lines and the float table all wait for
+        // prepareToPlay or for their feature to be switched on. the integer
+        // tables are normally cache hits.
+        rebuildAllTables();
     }
     ~BitmaskerEngine() { }
 
-    std::atomic<std::array<uint8, N_BITS>> bitremap;
-//    std::atomic<uint8> andmask, ormask, xormask;
-    std::atomic<std::bitset<N_BITS>> andmask, ormask, xormask;
     std::atomic<bool> removedenormals;
     std::atomic<double> entropyval, entropyamt;
 
-    std::array<double, 64> lastsamps; // todo: remove arbitrary channel count limit
+    std::atomic<BitDelay::Op> delayOp;
+    std::atomic<bool> delayFeedback;
+    std::atomic<double> delaySeconds;
+
+    std::atomic<ChannelBitMixer::Mode> crossMode;
+    std::atomic<std::bitset<N_BITS>> crossMask;
+    std::atomic<int> crossOffset;
+
+    // 32-bit float mode, indexed like the integer masks (bit 0 = lsb of the mantissa)
+    std::atomic<bool> floatMode;
+    std::atomic<std::bitset<32>> floatandmask, floatormask, floatxormask;
+    std::atomic<std::array<uint8, 32>> floatbitremap;
+
+    // 1 runs everything full band; 2-4 splits first and gives each band its own masks and remap
+    std::atomic<int> numBands;
+    std::array<std::atomic<float>, BandSplitter::maxCrossovers> crossoverFreqs;
+
+    // random flips ahead of the table, see BitNoise. indexed like the masks (0 = lsb)
+    std::array<std::atomic<float>, N_BITS> flipProbability;
+    std::atomic<uint64> noiseSeed;
+
+    // midi, full band integer mode only. while a note from midiLowestNote up is held its
+    // bit is flipped (channel 1), cleared (channel 2) or set (channel 3), on top of the
+    // table. program changes pick a remap preset (0 is the remap set by hand), but only
+    // while programChangeRemaps is on, since that's seven more tables to build per edit.
+    static constexpr int midiLowestNote = 36;
+    static constexpr int numRemapPresets = 8;
+    static constexpr int maxMidiSegments = 256;
+    std::atomic<bool> programChangeRemaps;
+
+    std::vector<double> lastsamps;
     int _numChannels = 0;
 
 
-    std::array<std::unique_ptr<juce::dsp::IIR::Filter<double>>, 64> removeDCOffset;
+    // sized to the layout in prepareToPlay, all sharing one set of coefficients per sample rate
+    OwnedArray<juce::dsp::IIR::Filter<double>> removeDCOffset;
+    dsp::IIR::Coefficients<double>::Ptr dcCoefficients;
+    double dcCoefficientRate = 0;
 
-public:
+private:
+    /** the masks and remap for one band, and the table built from them and the shared expression.
+        band 0 is also what the engine uses when it isn't splitting. */
+    struct Band
+    {
+        std::atomic<std::array<uint8, N_BITS>> bitremap;
+        std::atomic<std::bitset<N_BITS>> andmask, ormask, xormask;
+        TripleBuffer<TableCache::Handle> tables;
+    };
+
+    BitExpression expression;
+    CriticalSection rebuildLock; // writers only, never taken on the audio thread
+    SharedResourcePointer<TableCache> tableCache; // declared before the bands so it outlives their handles
+    std::array<Band, BandSplitter::maxBands> bands;
+    TripleBuffer<std::unique_ptr<FloatBitTable>> floatTables;
+    bool floatTableBuilt = false;
 
-    void prepareToPlay(int numChannels, int samplesPerBlock, double SR)
+#if N_BITS == 8
+    AudioBuffer<char> convertedBuffer;
+#elif N_BITS == 16
+    AudioBuffer<char16_t> convertedBuffer;
+#endif
+
+    TripleBuffer<std::unique_ptr<BitDelay>> delays; // empty until the delay is first switched on
+    bool delayAllocated = false;
+    int preparedBlockSize = 0;
+    ChannelBitMixer mixer;
+    std::vector<BitWord*> channelPointers;
+    double sampleRate = 44100;
+
+    BandSplitter splitter;
+    std::array<AudioBuffer<float>, BandSplitter::maxBands> bandBuffers;
+
+    /** what midi is doing to the transform from start until the next segment. */
+    struct MidiSegment
     {
-        if (numChannels > 64) jassertfalse;
-        _numChannels = numChannels;
-        for (int i = 0; i < numChannels; ++i)
+        int start = 0;
+        BitWord flip = 0, clear = 0, set = 0;
+        int preset = 0;
+    };
+
+    std::array<TripleBuffer<TableCache::Handle>, numRemapPresets - 1> presetTables; // only while programChangeRemaps is on
+    bool presetTablesBuilt = false;
+    std::array<const TransformTable*, numRemapPresets> blockTables {};
+    std::array<MidiSegment, maxMidiSegments> segments;
+    int numSegments = 0;
+    MidiSegment midiState; // held notes and the current preset, carried across blocks
+
+    BitNoise noise;
+    std::array<float, N_BITS> blockProbabilities {};
+    int64 noiseClock = 0; // samples since prepareToPlay, or the host's timeline when it's playing
+
+    Band& bandAt(int band)
+    {
+        jassert(band >= 0 && band < BandSplitter::maxBands);
+        return bands[static_cast<size_t>(jlimit(0, BandSplitter::maxBands - 1, band))];
+    }
+
+    /** call from any non-audio thread after changing a band's masks or remap. */
+    void rebuildTable(int band)
+    {
+        const ScopedLock sl(rebuildLock);
+        Band& b = bandAt(band);
+        b.tables.publish(tableCache->acquire(expression, b.bitremap.load(), b.andmask.load(), b.ormask.load(), b.xormask.load()));
+
+        if (band == 0) rebuildPresetTables();
+    }
+
+    /** the remaps program changes switch to, with band 0's masks. call with rebuildLock held.
+        builds nothing until program changes are switched on, and lets go of the tables when they're switched off. */
+    void rebuildPresetTables()
+    {
+        if (! programChangeRemaps.load())
         {
-            removeDCOffset[i]->reset();
-            removeDCOffset[i]->prepare({SR, static_cast<uint32>(samplesPerBlock), static_cast<uint32>(numChannels)});
+            // twice, so only the tables the audio thread last picked up stay referenced
+            if (presetTablesBuilt)
+                for (auto& t : presetTables) { t.publish({}); t.publish({}); }
+
+            presetTablesBuilt = false;
+            return;
         }
+
+        // nothing can send a program change before playback, so constructing stays cheap
+        if (preparedBlockSize == 0) return;
+
+        const Band& b = bands[0];
+        for (int preset = 1; preset < numRemapPresets; ++preset)
+            presetTables[static_cast<size_t>(preset - 1)].publish(tableCache->acquire(expression, remapPreset(preset), b.andmask.load(), b.ormask.load(), b.xormask.load()));
+        presetTablesBuilt = true;
     }
 
-    void processSamplesContextReplacing(AudioBuffer<float>& a)
+    static std::array<uint8, N_BITS> remapPreset(int preset)
     {
-        ScopedNoDenormals nodenormals;
+        constexpr int half = N_BITS / 2;
+        std::array<uint8, N_BITS> r;
 
-#if N_BITS == 8
-        AudioBuffer<char> convertedBuffer(a.getNumChannels(), a.getNumSamples());
-#elif N_BITS == 16
-        AudioBuffer<char16_t> convertedBuffer(a.getNumChannels(), a.getNumSamples());
-#endif
+        for (int i = 0; i < N_BITS; ++i)
+        {
+            int to = i;
+            switch (preset)
+            {
+                case 1: to = N_BITS - 1 - i; break;                    // reversed
+                case 2: to = i ^ 1; break;                              // neighbours swapped
+                case 3: to = (i + 1) % N_BITS; break;                   // rotated up
+                case 4: to = (i + N_BITS - 1) % N_BITS; break;          // rotated down
+                case 5: to = (i + half) % N_BITS; break;                // halves swapped
+                case 6: to = i < half ? 2 * i : 2 * (i - half) + 1; break; // perfect shuffle
+                case 7: to = (i * 3) % N_BITS; break;                   // stride 3 scatter
+                default: break;
+            }
+            r[static_cast<size_t>(i)] = static_cast<uint8>(to);
+        }
+
+        return r;
+    }
+
+    /** folds one message into s. false if it's not one bitty listens to. */
+    static bool applyMidi(const MidiMessage& m, MidiSegment& s, bool usePresets) noexcept
+    {
+        if (m.isProgramChange())
+        {
+            if (! usePresets) return false;
+
+            s.preset = m.getProgramChangeNumber() % numRemapPresets;
+            return true;
+        }
+
+        if (m.isAllNotesOff() || m.isAllSoundOff())
+        {
+            s.flip = s.clear = s.set = 0;
+            return true;
+        }
+
+        if (! m.isNoteOn() && ! m.isNoteOff()) return false;
+
+        const int bit = m.getNoteNumber() - midiLowestNote;
+        if (! isPositiveAndBelow(bit, N_BITS)) return false;
+
+        BitWord* target = m.getChannel() == 1 ? &s.flip
+                        : m.getChannel() == 2 ? &s.clear
+                        : m.getChannel() == 3 ? &s.set
+                        : nullptr;
+        if (target == nullptr) return false;
+
+        const BitWord b = static_cast<BitWord>(1u << bit);
+        *target = static_cast<BitWord>(m.isNoteOn() ? (*target | b) : (*target & ~b));
+        return true;
+    }
+
+    /** splits the block into runs with constant midi state, each starting on its event's sample. */
+    void collectMidi(const MidiBuffer& midi, int n) noexcept
+    {
+        const bool usePresets = programChangeRemaps.load();
+        if (! usePresets) midiState.preset = 0;
+
+        numSegments = 1;
+        segments[0] = midiState;
+        segments[0].start = 0;
+
+        for (const auto meta : midi)
+        {
+            if (! applyMidi(meta.getMessage(), midiState, usePresets)) continue;
+
+            const int pos = jlimit(0, n - 1, meta.samplePosition);
+            MidiSegment& last = segments[static_cast<size_t>(numSegments - 1)];
+
+            if (pos > last.start && numSegments < maxMidiSegments)
+            {
+                segments[static_cast<size_t>(numSegments)] = midiState;
+                segments[static_cast<size_t>(numSegments)].start = pos;
+                ++numSegments;
+            }
+            else
+            {
+                // same sample as the last event (or out of room): the later state wins
+                const int start = last.start;
+                last = midiState;
+                last.start = start;
+            }
+        }
+    }
+
+    int segmentEnd(int seg, int n) const noexcept { return seg + 1 < numSegments ? segments[static_cast<size_t>(seg + 1)].start : n; }
+
+    /** the expression is shared, so changing it touches every band. */
+    void rebuildAllTables()
+    {
+        for (int band = 0; band < BandSplitter::maxBands; ++band) rebuildTable(band);
+    }
+
+    void rebuildFloatTable()
+    {
+        const ScopedLock sl(rebuildLock);
+
+        // nothing reads it until float mode is on
+        if (! floatTableBuilt && ! floatMode.load()) return;
+
+        floatTableBuilt = true;
+        floatTables.publish(FloatBitTable::build(floatbitremap.load(), floatandmask.load(), floatormask.load(), floatxormask.load()));
+    }
+
+    /** builds the delay lines the first time they're needed. call with rebuildLock held. */
+    void allocateDelay()
+    {
+        if (delayAllocated || preparedBlockSize == 0) return;
+
+        auto d = std::make_unique<BitDelay>();
+        d->prepare(_numChannels, preparedBlockSize, sampleRate);
+        delays.publish(std::move(d));
+        delayAllocated = true;
+    }
+
+    void processFloatBits(AudioBuffer<float>& a)
+    {
+        // no conversion at all: the masks go straight onto the host's words.
+        // the delay and channel mixer work on integer words, so they sit this mode out.
+        const FloatBitTable* table = nullptr;
+
+        {
+            BITTY_TRACE_SCOPE("table acquire");
+            table = floatTables.acquire();
+        }
+
+        if (table == nullptr) return;
+
+        BITTY_TRACE_SCOPE("float bits");
+        for (int chan = 0; chan < a.getNumChannels(); ++chan)
+            table->process(a.getWritePointer(chan), a.getNumSamples());
+    }
 
+    /** a into convertedBuffer, resizing it only if the host breaks its promise about block size. */
+    void convertToWords(const AudioBuffer<float>& a)
+    {
+        convertedBuffer.setSize(a.getNumChannels(), a.getNumSamples(), false, false, true);
 
         for (int chan = 0; chan < a.getNumChannels(); ++chan)
         {
@@ -101,39 +389,10 @@ public:
 
             dst.convertSamples(src, a.getNumSamples());
         }
+    }
 
-
-        // at some point we will make this simd, obviously.
-        for (int chan = 0; chan < convertedBuffer.getNumChannels(); ++chan)
-        {
-            for (int i = 0; i < convertedBuffer.getNumSamples(); ++i)
-            {
-#if DEBUG
-                [[maybe_unused]] float floatval = a.getSample(chan, i); // orig float value
-    #if N_BITS == 8
-                [[maybe_unused]] int8 intval = convertedBuffer.getSample(chan, i);
-    #elif N_BITS == 16
-                [[maybe_unused]] int16 intval = convertedBuffer.getSample(chan, i);
-    #endif
-#endif
-
-                std::bitset<N_BITS> c(convertedBuffer.getSample(chan, i));
-                std::bitset<N_BITS> d;
-
-                for (uint8 idx = 0; idx < N_BITS; ++idx) { d.set(bitremap.load()[idx], c[idx]); }
-
-                d &= andmask.load();
-                d |= ormask.load();
-                d ^= xormask.load();
-
-#if N_BITS == 8
-                convertedBuffer.setSample(chan, i, d.to_ulong());
-#elif N_BITS == 16
-                convertedBuffer.setSample(chan, i, d.to_ulong());
-#endif
-            }
-        }
-
+    void convertFromWords(AudioBuffer<float>& a)
+    {
         for (int chan = 0; chan < a.getNumChannels(); ++chan)
         {
             AudioData::Pointer<AudioData::Float32,
@@ -153,46 +412,329 @@ public:
 
 
             dst.convertSamples(src, a.getNumSamples());
+        }
+    }
 
-//            if ()
-            for (int samp = 0; samp < a.getNumSamples(); ++samp)
+    BitWord* words(int chan) { return reinterpret_cast<BitWord*>(convertedBuffer.getWritePointer(chan)); }
+
+    void processIntegerBits(AudioBuffer<float>& a)
+    {
+        {
+            BITTY_TRACE_SCOPE("convert to int");
+            convertToWords(a);
+        }
+
+
+        {
+            BITTY_TRACE_SCOPE("bit noise");
+            for (size_t bit = 0; bit < blockProbabilities.size(); ++bit) blockProbabilities[bit] = flipProbability[bit].load();
+            noise.setProbabilities(blockProbabilities);
+
+            if (noise.isActive())
+            {
+                const uint64 seed = noiseSeed.load();
+                const int numNoisy = jmin(convertedBuffer.getNumChannels(), _numChannels);
+                for (int chan = 0; chan < numNoisy; ++chan) noise.process(chan, words(chan), a.getNumSamples(), noiseClock, seed);
+            }
+        }
+
+        BitDelay* delay = nullptr;
+
+        {
+            BITTY_TRACE_SCOPE("table acquire");
+            blockTables[0] = bands[0].tables.acquire();
+            for (int preset = 1; preset < numRemapPresets; ++preset)
+                blockTables[static_cast<size_t>(preset)] = presetTables[static_cast<size_t>(preset - 1)].acquire();
+
+            delay = delays.acquire();
+        }
+
+        {
+            BITTY_TRACE_SCOPE("transform");
+            const BitDelay::Op op = delayOp.load();
+            const bool feedback = delayFeedback.load();
+            const int delaySamps = roundToInt(delaySeconds.load() * sampleRate);
+            const int n = a.getNumSamples();
+
+            // notes only change the overlay below, so the kernel runs over whole
+            // stretches that share a table and only program changes split it
+            for (int seg = 0; seg < numSegments;)
             {
-                double entval = entropyval.load();
-                double entamt = entropyamt.load();
+                const int preset = segments[static_cast<size_t>(seg)].preset;
+                int next = seg + 1;
+                while (next < numSegments && segments[static_cast<size_t>(next)].preset == preset) ++next;
 
-                double nextval = (pow(entval, pow(lastsamps[chan] - a.getSample(chan, samp) + 1, (1.f/entval))) * entamt) + a.getSample(chan, samp) - entamt/2.f;
+                const int start = segments[static_cast<size_t>(seg)].start;
+                const int len = segmentEnd(next - 1, n) - start;
 
-                if (isnan(nextval)) { nextval = 0; }
-                else nextval = std::max(-1.0, std::min(nextval, 1.0));
+                const TransformTable* table = blockTables[static_cast<size_t>(preset)];
+                if (table == nullptr) table = blockTables[0];
 
-                if (samp % 5 == 0) removeDCOffset[chan]->snapToZero(); // every so often, remove denormals
-                nextval = removeDCOffset[chan]->processSample(nextval);
+                for (int chan = 0; chan < convertedBuffer.getNumChannels(); ++chan)
+                {
+                    BitWord* data = words(chan) + start;
 
-                a.setSample(chan, samp, nextval);
-                lastsamps[chan] = a.getSample(chan, samp);
+                    if (op == BitDelay::Op::off || delay == nullptr || chan >= _numChannels) table->process(data, len);
+                    else delay->process(chan, data, len, delaySamps, op, feedback, *table);
+                }
+
+                if (delay != nullptr) delay->advance(len);
+                seg = next;
             }
         }
 
+        {
+            BITTY_TRACE_SCOPE("midi bits");
+            for (int seg = 0; seg < numSegments; ++seg)
+            {
+                const MidiSegment& s = segments[static_cast<size_t>(seg)];
+                if ((s.flip | s.clear | s.set) == 0) continue;
 
+                const int len = segmentEnd(seg, a.getNumSamples()) - s.start;
+                const BitWord keep = static_cast<BitWord>(~s.clear), set = s.set, flip = s.flip;
 
+                for (int chan = 0; chan < convertedBuffer.getNumChannels(); ++chan)
+                {
+                    BitWord* data = words(chan) + s.start;
+                    for (int i = 0; i < len; ++i) data[i] = static_cast<BitWord>(((data[i] & keep) | set) ^ flip);
+                }
+            }
+        }
+
+        {
+            BITTY_TRACE_SCOPE("channel mix");
+            const int numMixed = jmin(convertedBuffer.getNumChannels(), _numChannels);
+            for (int chan = 0; chan < numMixed; ++chan)
+                channelPointers[static_cast<size_t>(chan)] = words(chan);
+
+            mixer.process(channelPointers.data(), numMixed, a.getNumSamples(), crossMode.load(), crossMask.load(), crossOffset.load());
+        }
 
+        {
+            BITTY_TRACE_SCOPE("convert to float");
+            convertFromWords(a);
+        }
     }
 
-    void setandmask(String newandmask) { andmask.store(std::bitset<N_BITS>(newandmask.toStdString())); }
-    void setormask(String newormask) { ormask.store(std::bitset<N_BITS>(newormask.toStdString())); }
-    void setxormask(String newxormask) { xormask.store(std::bitset<N_BITS>(newxormask.toStdString())); }
+    void processBands(AudioBuffer<float>& a, int numBandsToUse)
+    {
+        // each band is quantised and run through its own table, then the bands are
+        // added back up. the delay and channel mixer sit this mode out, as in float
+        // mode. a band whose table does nothing skips the round trip through
+        // integers entirely, so it comes through untouched rather than requantised.
+        const int numChannels = jmin(a.getNumChannels(), _numChannels);
+        const int n = a.getNumSamples();
+
+        {
+            BITTY_TRACE_SCOPE("band split");
+            std::array<float, BandSplitter::maxCrossovers> freqs;
+            for (size_t i = 0; i < freqs.size(); ++i) freqs[i] = crossoverFreqs[i].load();
+            splitter.setCrossovers(freqs);
+
+            for (int b = 0; b < numBandsToUse; ++b)
+                bandBuffers[static_cast<size_t>(b)].setSize(numChannels, n, false, false, true);
+
+            splitter.process(a, bandBuffers, numBandsToUse);
+        }
+
+        std::array<const TransformTable*, BandSplitter::maxBands> bandTables {};
 
-    void setBitRemapBit(uint8 bitToSet, uint8 valueToSet)
+        {
+            BITTY_TRACE_SCOPE("table acquire");
+            for (int b = 0; b < numBandsToUse; ++b)
+                bandTables[static_cast<size_t>(b)] = bands[static_cast<size_t>(b)].tables.acquire();
+        }
+
+        {
+            BITTY_TRACE_SCOPE("band transform");
+            for (int b = 0; b < numBandsToUse; ++b)
+            {
+                const TransformTable* table = bandTables[static_cast<size_t>(b)];
+                if (table == nullptr || table->isIdentity()) continue;
+
+                AudioBuffer<float>& band = bandBuffers[static_cast<size_t>(b)];
+                convertToWords(band);
+                for (int chan = 0; chan < numChannels; ++chan) table->process(words(chan), n);
+                convertFromWords(band);
+            }
+        }
+
+        {
+            BITTY_TRACE_SCOPE("band sum");
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                float* out = a.getWritePointer(chan);
+                FloatVectorOperations::copy(out, bandBuffers[0].getReadPointer(chan), n);
+                for (int b = 1; b < numBandsToUse; ++b)
+                    FloatVectorOperations::add(out, bandBuffers[static_cast<size_t>(b)].getReadPointer(chan), n);
+            }
+        }
+    }
+
+public:
+
+    void prepareToPlay(int numChannels, int samplesPerBlock, double SR)
+    {
+        if (numChannels > 64) jassertfalse;
+        _numChannels = numChannels;
+        sampleRate = SR;
+
+        convertedBuffer.setSize(numChannels, samplesPerBlock);
+        mixer.prepare(numChannels, samplesPerBlock);
+        splitter.prepare(numChannels, SR);
+        noise.prepare(numChannels);
+        noiseClock = 0;
+        for (auto& b : bandBuffers) b.setSize(numChannels, samplesPerBlock);
+        channelPointers.assign(static_cast<size_t>(numChannels), nullptr);
+        lastsamps.assign(static_cast<size_t>(numChannels), 0.0);
+
+        if (dcCoefficients == nullptr || ! approximatelyEqual(dcCoefficientRate, SR))
+        {
+            dcCoefficients = dsp::IIR::Coefficients<double>::makeFirstOrderHighPass(SR, 1);
+            dcCoefficientRate = SR;
+        }
+
+        while (removeDCOffset.size() < numChannels) removeDCOffset.add(new dsp::IIR::Filter<double>(dcCoefficients));
+        removeDCOffset.removeLast(removeDCOffset.size() - numChannels);
+
+        for (auto* f : removeDCOffset)
+        {
+            f->coefficients = dcCoefficients;
+            f->reset();
+        }
+
+        {
+            const ScopedLock sl(rebuildLock);
+            preparedBlockSize = samplesPerBlock;
+            rebuildPresetTables();
+            midiState = {};
+
+            // the old lines are the wrong size now; rebuild them if they were ever used
+            if (delayAllocated || delayOp.load() != BitDelay::Op::off)
+            {
+                delayAllocated = false;
+                allocateDelay();
+            }
+        }
+    }
+
+    /** audio thread, before processing. lines the flip noise up with the host's
+        timeline, so playback matches an offline render from the same position. */
+    void syncNoiseClock(int64 timelineSample) noexcept { noiseClock = jmax(static_cast<int64>(0), timelineSample); }
+
+    void processSamplesContextReplacing(AudioBuffer<float>& a)
+    {
+        processSamplesContextReplacing(a, MidiBuffer());
+    }
+
+    /** the midi events land on their own sample; see midiLowestNote for what they do. */
+    void processSamplesContextReplacing(AudioBuffer<float>& a, const MidiBuffer& midi)
+    {
+        ScopedNoDenormals nodenormals;
+
+        if (a.getNumSamples() == 0) return;
+
+        // kept up to date in every mode, so held notes are right when switching back
+        collectMidi(midi, a.getNumSamples());
+
+        const int numBandsToUse = jlimit(1, BandSplitter::maxBands, numBands.load());
+
+        if (floatMode.load()) processFloatBits(a);
+        else if (numBandsToUse > 1) processBands(a, numBandsToUse);
+        else processIntegerBits(a);
+
+        noiseClock += a.getNumSamples();
+
+        {
+            BITTY_TRACE_SCOPE("entropy + dc");
+            for (int chan = 0; chan < jmin(a.getNumChannels(), removeDCOffset.size()); ++chan)
+            {
+//            if ()
+                for (int samp = 0; samp < a.getNumSamples(); ++samp)
+                {
+                    double entval = entropyval.load();
+                    double entamt = entropyamt.load();
+
+                    double nextval = (pow(entval, pow(lastsamps[chan] - a.getSample(chan, samp) + 1, (1.f/entval))) * entamt) + a.getSample(chan, samp) - entamt/2.f;
+
+                    if (isnan(nextval)) { nextval = 0; }
+                    else nextval = std::max(-1.0, std::min(nextval, 1.0));
+
+                    if (samp % 5 == 0) removeDCOffset[chan]->snapToZero(); // every so often, remove denormals
+                    nextval = removeDCOffset[chan]->processSample(nextval);
+
+                    a.setSample(chan, samp, nextval);
+                    lastsamps[chan] = a.getSample(chan, samp);
+                }
+            }
+        }
+
+
+
+
+    }
+
+    // the band argument only matters once the engine is splitting; band 0 is the full band settings
+    void setandmask(String newandmask, int band = 0) { Band& b = bandAt(band); b.andmask.store(parseMask(newandmask, b.andmask.load())); rebuildTable(band); }
+    void setormask(String newormask, int band = 0) { Band& b = bandAt(band); b.ormask.store(parseMask(newormask, b.ormask.load())); rebuildTable(band); }
+    void setxormask(String newxormask, int band = 0) { Band& b = bandAt(band); b.xormask.store(parseMask(newxormask, b.xormask.load())); rebuildTable(band); }
+
+    void setBitRemapBit(uint8 bitToSet, uint8 valueToSet, int band = 0)
     {
         assert(bitToSet < N_BITS);
         assert(valueToSet < N_BITS);
 
-        bitremap.load()[bitToSet] = valueToSet;
+        const ScopedLock sl(rebuildLock);
+        auto r = bandAt(band).bitremap.load();
+        r[bitToSet] = valueToSet;
+        bandAt(band).bitremap.store(r);
+        rebuildTable(band);
+    }
+
+    void setEntireBitRemap(std::array<uint8, N_BITS> newBitRemap, int band = 0)
+    {
+        bandAt(band).bitremap.store(newBitRemap);
+        rebuildTable(band);
     }
 
-    void setEntireBitRemap(std::array<uint8, N_BITS> newBitRemap)
+    void setFlipProbability(int bit, float newprobability)
+    {
+        jassert(isPositiveAndBelow(bit, N_BITS));
+        flipProbability[static_cast<size_t>(jlimit(0, N_BITS - 1, bit))].store(std::isfinite(newprobability) ? jlimit(0.0f, 1.0f, newprobability) : 0.0f);
+    }
+
+    void setNoiseSeed(uint64 newseed) { noiseSeed.store(newseed); }
+
+    void setProgramChangeRemaps(bool shouldUsePresets)
+    {
+        const ScopedLock sl(rebuildLock);
+        programChangeRemaps.store(shouldUsePresets);
+        rebuildPresetTables();
+    }
+
+    void setNumBands(int newnumbands) { numBands.store(jlimit(1, BandSplitter::maxBands, newnumbands)); }
+
+    /** index 0 is the lowest crossover; they get sorted before use, so the order doesn't have to hold. */
+    void setCrossover(int index, float newfreq)
     {
-        bitremap.store(newBitRemap);
+        jassert(index >= 0 && index < BandSplitter::maxCrossovers);
+        if (! std::isfinite(newfreq)) return;
+        crossoverFreqs[static_cast<size_t>(jlimit(0, BandSplitter::maxCrossovers - 1, index))].store(jlimit(20.0f, 20000.0f, newfreq));
+    }
+
+    /** parses and installs a transform expression (see BitExpression), applied before the remap and masks.
+        an empty string or "x" means no expression. on a parse error nothing changes. */
+    Result setExpression(const String& newExpression)
+    {
+        const ScopedLock sl(rebuildLock);
+
+        BitExpression e;
+        Result r = e.parse(newExpression, N_BITS);
+        if (r.failed()) return r;
+
+        expression = e;
+        rebuildAllTables();
+        return r;
     }
 
     void setEntropyVal(double newentropyval)
@@ -205,10 +747,224 @@ public:
         entropyamt.store(newentropyamt);
     }
 
+    void setDelayOp(BitDelay::Op newop)
+    {
+        if (newop != BitDelay::Op::off)
+        {
+            const ScopedLock sl(rebuildLock);
+            allocateDelay();
+        }
+
+        delayOp.store(newop);
+    }
+
+    void setDelayFeedback(bool shouldFeedBack) { delayFeedback.store(shouldFeedBack); }
+    void setDelaySeconds(double newseconds) { if (std::isfinite(newseconds)) delaySeconds.store(jlimit(0.0, BitDelay::maxDelaySeconds, newseconds)); }
+
+    void setFloatMode(bool shouldUseFloatBits)
+    {
+        floatMode.store(shouldUseFloatBits);
+        if (shouldUseFloatBits) rebuildFloatTable();
+    }
+
+    void setfloatandmask(String newandmask) { floatandmask.store(parseMask(newandmask, floatandmask.load())); rebuildFloatTable(); }
+    void setfloatormask(String newormask) { floatormask.store(parseMask(newormask, floatormask.load())); rebuildFloatTable(); }
+    void setfloatxormask(String newxormask) { floatxormask.store(parseMask(newxormask, floatxormask.load())); rebuildFloatTable(); }
+
+    void setEntireFloatBitRemap(std::array<uint8, 32> newBitRemap)
+    {
+        floatbitremap.store(newBitRemap);
+        rebuildFloatTable();
+    }
+
+    void setCrossMode(ChannelBitMixer::Mode newmode) { crossMode.store(newmode); }
+    void setCrossMask(String newcrossmask) { crossMask.store(parseMask(newcrossmask, crossMask.load())); }
+    void setCrossOffset(int newoffset) { crossOffset.store(jlimit(0, 63, newoffset)); }
+
+
+    /** everything the engine needs to come back the same, as saved by the plugin and the preset tools. */
+    ValueTree getState()
+    {
+        ValueTree vt("settings");
+
+
+        vt.setProperty("version", "0.0.0", nullptr);
+        vt.setProperty("license", "GNU Affero General Public License v3.0", nullptr);
+
+        vt.setProperty("xormask", getxormask(), nullptr);
+        vt.setProperty("ormask", getormask(), nullptr);
+        vt.setProperty("andmask", getandmask(), nullptr);
+        vt.setProperty("remapvals", remapToString(getbitremap()), nullptr);
+        vt.setProperty("expression", getExpression(), nullptr);
+
+        // band 0 is the plain keys above, so older sessions load as its settings
+        vt.setProperty("numbands", getNumBands(), nullptr);
+        for (int band = 1; band < BandSplitter::maxBands; ++band)
+        {
+            const String prefix = "band" + String(band);
+            vt.setProperty(prefix + "xormask", getxormask(band), nullptr);
+            vt.setProperty(prefix + "ormask", getormask(band), nullptr);
+            vt.setProperty(prefix + "andmask", getandmask(band), nullptr);
+            vt.setProperty(prefix + "remapvals", remapToString(getbitremap(band)), nullptr);
+        }
+        for (int i = 0; i < BandSplitter::maxCrossovers; ++i)
+        {
+            vt.setProperty("crossover" + String(i + 1), getCrossover(i), nullptr);
+        }
+
+        vt.setProperty("delayop", static_cast<int>(getDelayOp()), nullptr);
+        vt.setProperty("delayfeedback", getDelayFeedback(), nullptr);
+        vt.setProperty("delayseconds", getDelaySeconds(), nullptr);
+
+        vt.setProperty("crossmode", static_cast<int>(getCrossMode()), nullptr);
+        vt.setProperty("crossmask", getCrossMask(), nullptr);
+        vt.setProperty("crossoffset", getCrossOffset(), nullptr);
+
+        String flips;
+        for (int bit = 0; bit < N_BITS; ++bit) flips << (bit > 0 ? " " : "") << String(getFlipProbability(bit));
+        vt.setProperty("flipprobs", flips, nullptr);
+        vt.setProperty("noiseseed", String(static_cast<int64>(getNoiseSeed())), nullptr);
+        vt.setProperty("programchanges", getProgramChangeRemaps(), nullptr);
+
+        vt.setProperty("floatmode", getFloatMode(), nullptr);
+        vt.setProperty("floatxormask", getfloatxormask(), nullptr);
+        vt.setProperty("floatormask", getfloatormask(), nullptr);
+        vt.setProperty("floatandmask", getfloatandmask(), nullptr);
+
+        String floatremapString;
+        for (uint8 v : getfloatbitremap())
+        {
+            floatremapString += String::toHexString(static_cast<int>(v)).paddedLeft('0', 2);
+        }
+        vt.setProperty("floatremapvals", floatremapString, nullptr);
+
+        return vt;
+    }
+
+    /** everything is read into place first and the tables are built once at the end;
+        going through the setters would rebuild them for every key. */
+    void setState(const ValueTree& vt)
+    {
+        BitExpression e;
+        const bool expressionParsed = e.parse(vt.getProperty("expression").toString(), N_BITS).wasOk();
+
+        {
+            const ScopedLock sl(rebuildLock);
+
+            // band 0 is the plain keys
+            for (int band = 0; band < BandSplitter::maxBands; ++band)
+                readBandState(vt, band == 0 ? String() : "band" + String(band), bands[static_cast<size_t>(band)]);
 
-    String getandmask() { return String(andmask.load().to_string()); }
-    String getormask() { return String(ormask.load().to_string()); }
-    String getxormask() { return String(xormask.load().to_string()); }
-    std::array<uint8, N_BITS> getbitremap() { return bitremap.load(); }
+            if (expressionParsed) expression = e;
+            programChangeRemaps.store(vt.getProperty("programchanges", false));
+            rebuildAllTables();
+        }
+
+        setNumBands(vt.getProperty("numbands", 1));
+        for (int i = 0; i < BandSplitter::maxCrossovers; ++i)
+        {
+            const String key = "crossover" + String(i + 1);
+            if (vt.hasProperty(key)) setCrossover(i, vt.getProperty(key));
+        }
+
+        setDelayOp(static_cast<BitDelay::Op>(jlimit(0, 3, static_cast<int>(vt.getProperty("delayop", 0)))));
+        setDelayFeedback(vt.getProperty("delayfeedback", false));
+        setDelaySeconds(vt.getProperty("delayseconds", 0.25));
+
+        setCrossMode(static_cast<ChannelBitMixer::Mode>(jlimit(0, 3, static_cast<int>(vt.getProperty("crossmode", 0)))));
+        if (vt.hasProperty("crossmask")) setCrossMask(vt.getProperty("crossmask"));
+        setCrossOffset(vt.getProperty("crossoffset", 1));
+
+        // lsb first, one per bit
+        StringArray flips = StringArray::fromTokens(vt.getProperty("flipprobs").toString(), " ", "");
+        for (int bit = 0; bit < N_BITS; ++bit)
+            setFlipProbability(bit, bit < flips.size() ? flips[bit].getFloatValue() : 0.0f);
+        if (vt.hasProperty("noiseseed")) setNoiseSeed(static_cast<uint64>(vt.getProperty("noiseseed").toString().getLargeIntValue()));
+
+        floatMode.store(vt.getProperty("floatmode", false));
+        floatxormask.store(parseMask(vt.getProperty("floatxormask").toString(), floatxormask.load()));
+        floatormask.store(parseMask(vt.getProperty("floatormask").toString(), floatormask.load()));
+        floatandmask.store(parseMask(vt.getProperty("floatandmask").toString(), floatandmask.load()));
+
+        // two hex digits per bit
+        String floatremap = vt.getProperty("floatremapvals");
+        if (floatremap.length() == 64)
+        {
+            std::array<uint8, 32> floatbits;
+            for (int i = 0; i < 32; ++i)
+            {
+                floatbits[static_cast<size_t>(i)] = static_cast<uint8>(floatremap.substring(i * 2, i * 2 + 2).getHexValue32() & 31);
+            }
+            floatbitremap.store(floatbits);
+        }
+
+        rebuildFloatTable();
+    }
+
+    String getandmask(int band = 0) { return String(bandAt(band).andmask.load().to_string()); }
+    String getormask(int band = 0) { return String(bandAt(band).ormask.load().to_string()); }
+    String getxormask(int band = 0) { return String(bandAt(band).xormask.load().to_string()); }
+    std::array<uint8, N_BITS> getbitremap(int band = 0) { return bandAt(band).bitremap.load(); }
+    int getNumBands() { return numBands.load(); }
+    float getFlipProbability(int bit) { return flipProbability[static_cast<size_t>(jlimit(0, N_BITS - 1, bit))].load(); }
+    uint64 getNoiseSeed() { return noiseSeed.load(); }
+    bool getProgramChangeRemaps() { return programChangeRemaps.load(); }
+    float getCrossover(int index) { return crossoverFreqs[static_cast<size_t>(jlimit(0, BandSplitter::maxCrossovers - 1, index))].load(); }
+    BitDelay::Op getDelayOp() { return delayOp.load(); }
+    bool getDelayFeedback() { return delayFeedback.load(); }
+    double getDelaySeconds() { return delaySeconds.load(); }
+    bool getFloatMode() { return floatMode.load(); }
+    String getfloatandmask() { return String(floatandmask.load().to_string()); }
+    String getfloatormask() { return String(floatormask.load().to_string()); }
+    String getfloatxormask() { return String(floatxormask.load().to_string()); }
+    std::array<uint8, 32> getfloatbitremap() { return floatbitremap.load(); }
+    ChannelBitMixer::Mode getCrossMode() { return crossMode.load(); }
+    String getCrossMask() { return String(crossMask.load().to_string()); }
+    int getCrossOffset() { return crossOffset.load(); }
+    /** process-wide, covers every instance sharing the cache. */
+    TableCache::Stats getTableCacheStats() const { return tableCache->getStats(); }
+
+    String getExpression() { const ScopedLock sl(rebuildLock); return expression.getText(); }
+
+private:
+    /** std::bitset throws on anything but '0' and '1', and these strings can come
+        straight out of a session file; a bad one leaves the mask as it was. */
+    template <size_t numBits>
+    static std::bitset<numBits> parseMask(const String& s, std::bitset<numBits> current)
+    {
+        if (s.isEmpty() || ! s.containsOnly("01")) return current;
+        return std::bitset<numBits>(s.toStdString());
+    }
+
+    /** one band's masks and remap from a saved state, prefix being "" for band 0 or "bandN".
+        missing or malformed keys leave that setting as it was. doesn't rebuild anything. */
+    static void readBandState(const ValueTree& vt, const String& prefix, Band& b)
+    {
+        b.xormask.store(parseMask(vt.getProperty(prefix + "xormask").toString(), b.xormask.load()));
+        b.ormask.store(parseMask(vt.getProperty(prefix + "ormask").toString(), b.ormask.load()));
+        b.andmask.store(parseMask(vt.getProperty(prefix + "andmask").toString(), b.andmask.load()));
+
+        std::array<uint8, N_BITS> bits;
+        if (remapFromString(vt.getProperty(prefix + "remapvals"), bits)) b.bitremap.store(bits);
+    }
+
+    // one hex digit per bit, same as the editor shows it
+    static String remapToString(const std::array<uint8, N_BITS>& remap)
+    {
+        String s;
+        for (uint8 v : remap) s += String::toHexString(static_cast<int>(v)).toUpperCase();
+        return s;
+    }
+
+    // anything but N_BITS hex digits is rejected and leaves the remap as it was
+    static bool remapFromString(const String& s, std::array<uint8, N_BITS>& bits)
+    {
+        if (s.length() != N_BITS || ! s.containsOnly("0123456789abcdefABCDEF")) return false;
+
+        for (int i = 0; i < N_BITS; ++i)
+            bits[static_cast<size_t>(i)] = static_cast<uint8>(jlimit(0, N_BITS - 1, CharacterFunctions::getHexDigitValue(s[i])));
+
+        return true;
+    }
 
 };
@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    FloatBits.h
+    Created: 19 Oct 2026 6:48:55pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <bitset>
+#include <cstring>
+#include <memory>
+
+
+/**
+    Bit manipulation straight on the IEEE-754 words of the host buffer, so no
+    quantisation and no conversion. Bit 31 is the sign, 30-23 the exponent and
+    22-0 the mantissa, same numbering as the 32-character mask strings (MSB
+    first).
+
+    The remap goes through 256-entry byte tables (one lookup per byte, ORed
+    together), so unlike the integer table it can't express collisions as
+    "last bit wins"; bits mapped to the same place OR together. Bits that stay
+    put are masked through instead, and a byte with none of its bits moving
+    isn't looked up at all, so swapping a pair of mantissa bits costs one
+    lookup. With an identity remap it's plain and/or/xor and vectorises.
+*/
+struct FloatBitTable
+{
+    static constexpr uint32 signBits     = 0x80000000u;
+    static constexpr uint32 exponentBits = 0x7f800000u;
+    static constexpr uint32 mantissaBits = 0x007fffffu;
+
+    uint32 andBits = 0xffffffffu, orBits = 0, xorBits = 0;
+    bool identityRemap = true;
+
+    // the bits the remap leaves where they are, and which bytes have any that move
+    uint32 keptBits = 0xffffffffu;
+    std::array<bool, 4> movedBytes {};
+    std::array<std::array<uint32, 256>, 4> byteLut;
+
+    static std::unique_ptr<FloatBitTable> build(const std::array<uint8, 32>& remap,
+                                                std::bitset<32> andmask,
+                                                std::bitset<32> ormask,
+                                                std::bitset<32> xormask)
+    {
+        auto t = std::make_unique<FloatBitTable>();
+
+        t->andBits = static_cast<uint32>(andmask.to_ulong());
+        t->orBits = static_cast<uint32>(ormask.to_ulong());
+        t->xorBits = static_cast<uint32>(xormask.to_ulong());
+
+        for (uint8 idx = 0; idx < 32; ++idx)
+        {
+            if (remap[idx] == idx) continue;
+
+            t->identityRemap = false;
+            t->keptBits &= ~(1u << idx);
+            t->movedBytes[static_cast<size_t>(idx / 8)] = true;
+        }
+
+        for (int byte = 0; byte < 4; ++byte)
+        {
+            for (uint32 v = 0; v < 256; ++v)
+            {
+                uint32 out = 0;
+                for (int b = 0; b < 8; ++b)
+                {
+                    const auto idx = static_cast<size_t>(byte * 8 + b);
+                    if (((v >> b) & 1) && remap[idx] != idx && remap[idx] < 32) out |= 1u << remap[idx];
+                }
+                t->byteLut[static_cast<size_t>(byte)][v] = out;
+            }
+        }
+
+        return t;
+    }
+
+    /** in place on the host's float buffer, audio thread. */
+    void process(float* samples, int n) const noexcept
+    {
+        if (identityRemap) processMasks(samples, n);
+        else               processRemapped(samples, n);
+    }
+
+private:
+    // an all-ones exponent is inf or nan; neither should reach the host. keep the sign, drop to zero.
+    static uint32 guard(uint32 u) noexcept { return (u & exponentBits) == exponentBits ? (u & signBits) : u; }
+
+    void processMasks(float* samples, int n) const noexcept
+    {
+        const uint32 am = andBits, om = orBits, xm = xorBits;
+
+        for (int i = 0; i < n; ++i)
+        {
+            uint32 u;
+            std::memcpy(&u, samples + i, sizeof(u));
+            u = guard(((u & am) | om) ^ xm);
+            std::memcpy(samples + i, &u, sizeof(u));
+        }
+    }
+
+    void processRemapped(float* samples, int n) const noexcept
+    {
+        const uint32 am = andBits, om = orBits, xm = xorBits, kept = keptBits;
+        const bool b0 = movedBytes[0], b1 = movedBytes[1], b2 = movedBytes[2], b3 = movedBytes[3];
+
+        for (int i = 0; i < n; ++i)
+        {
+            uint32 u;
+            std::memcpy(&u, samples + i, sizeof(u));
+            u = (u & kept) | (b0 ? byteLut[0][u & 0xff] : 0) | (b1 ? byteLut[1][(u >> 8) & 0xff] : 0)
+                           | (b2 ? byteLut[2][(u >> 16) & 0xff] : 0) | (b3 ? byteLut[3][u >> 24] : 0);
+            u = guard(((u & am) | om) ^ xm);
+            std::memcpy(samples + i, &u, sizeof(u));
+        }
+    }
+};
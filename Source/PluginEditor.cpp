@@ -10,38 +10,33 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+// the float remap's digits: 0-9 then A-V for bits 10 to 31
+static const String floatRemapDigits("0123456789ABCDEFGHIJKLMNOPQRSTUV");
+
 //==============================================================================
 bittyAudioProcessorEditor::bittyAudioProcessorEditor (bittyAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor(p)
 {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (500, 620);
     setResizable(true, true);
-    setResizeLimits(400, 300, 4000, 3000);
-
+    setResizeLimits(400, 400, 4000, 3000);
 
 
-    String bitremaptext;
 
+    crossMaskEditor.setText(audioProcessor.ed.getCrossMask());
 
-    for (int i = 0; i < N_BITS; ++i)
+    // one probability for whichever bits are ticked, msb first like the masks
+    String flipbits;
+    float flipamount = 0.0f;
+    for (int bit = N_BITS - 1; bit >= 0; --bit)
     {
-        int bitremapfori = static_cast<int>(audioProcessor.ed.getbitremap()[i]);
-        if (bitremapfori < 9)
-        {
-            bitremaptext += bitremapfori;
-        }
-        else
-        {
-            bitremaptext += String::toHexString(bitremapfori);
-        }
+        const float p = audioProcessor.ed.getFlipProbability(bit);
+        flipbits += p > 0 ? "1" : "0";
+        flipamount = jmax(flipamount, p);
     }
-
-    xorMaskEditor.setText(audioProcessor.ed.getxormask());
-    orMaskEditor.setText(audioProcessor.ed.getormask());
-    andMaskEditor.setText(audioProcessor.ed.getandmask());
-    bitRemapEditor.setText(bitremaptext);
+    flipBitsEditor.setText(flipbits);
 
 #if N_BITS == 16
     xorMaskEditor.setTextToShowWhenEmpty("0000000000000000", juce::Colours::grey);
@@ -79,19 +74,64 @@ bittyAudioProcessorEditor::bittyAudioProcessorEditor (bittyAudioProcessor& p)
     bitRemapEditor.setInputFilter(infilt, true);
     infilt = nullptr;
 
+    // the and/or/xor/remap editors show whichever band is picked here
+    for (int band = 0; band < BandSplitter::maxBands; ++band)
+    {
+        numBandsBox.addItem(band == 0 ? "1 band" : String(band + 1) + " bands", band + 1);
+        editBandBox.addItem("edit band " + String(band + 1), band + 1);
+    }
+    numBandsBox.setSelectedId(audioProcessor.ed.getNumBands(), dontSendNotification);
+    numBandsBox.addListener(this);
+    editBandBox.setSelectedId(1, dontSendNotification);
+    editBandBox.addListener(this);
+    showBand();
+
+    for (int i = 0; i < BandSplitter::maxCrossovers; ++i)
+    {
+        Slider& x = crossoverSliders[static_cast<size_t>(i)];
+        x.setRange({20.0, 20000.0}, 1.0);
+        x.setSkewFactorFromMidPoint(1000.0);
+        x.setTextValueSuffix(" Hz");
+        x.setSliderStyle(juce::Slider::LinearHorizontal);
+        x.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 16);
+        x.setValue(audioProcessor.ed.getCrossover(i), dontSendNotification);
+        x.addListener(this);
+        addAndMakeVisible(x);
+    }
+
+    bandsLabel.setText("bands", dontSendNotification);
+    bandsLabel.attachToComponent(&numBandsBox, true);
+
+    addAndMakeVisible(numBandsBox);
+    addAndMakeVisible(editBandBox);
+
+    expressionEditor.addListener(this);
+    expressionEditor.setMultiLine(false);
+    expressionEditor.setText(audioProcessor.ed.getExpression());
+    expressionEditor.setTextToShowWhenEmpty("x", juce::Colours::grey);
+    addAndMakeVisible(expressionEditor);
+
 
     xorLabel.setText("xor mask", dontSendNotification);
     andLabel.setText("and mask", dontSendNotification);
     orLabel.setText("or mask", dontSendNotification);
     entropySliderLabel.setText("entropy", dontSendNotification);
     bitremapLabel.setText("bit remapping", dontSendNotification);
+    expressionLabel.setText("expression", dontSendNotification);
 
     xorLabel.attachToComponent(&xorMaskEditor, true);
     andLabel.attachToComponent(&andMaskEditor, true);
     orLabel.attachToComponent(&orMaskEditor, true);
     entropySliderLabel.attachToComponent(&entropySlider, true);
+    expressionLabel.attachToComponent(&expressionEditor, true);
 //    bitremapLabel.attachToComponent(&bitRemapEditor, true);
 
+    // off by default: the presets are seven more tables to build on every edit
+    programChangeButton.setButtonText("program changes pick presets");
+    programChangeButton.setToggleState(audioProcessor.ed.getProgramChangeRemaps(), dontSendNotification);
+    programChangeButton.addListener(this);
+    addAndMakeVisible(programChangeButton);
+
 
 
     entropySlider.setRange({0.0, 1.0}, 0.0000001);
@@ -111,6 +151,95 @@ bittyAudioProcessorEditor::bittyAudioProcessorEditor (bittyAudioProcessor& p)
     addAndMakeVisible(entropyAmtSlider);
     addAndMakeVisible(entropySlider);
 
+    // combo ids are the BitDelay::Op values + 1, since 0 means "nothing selected"
+    delayOpBox.addItem("off", static_cast<int>(BitDelay::Op::off) + 1);
+    delayOpBox.addItem("x ^ delayed", static_cast<int>(BitDelay::Op::xorOp) + 1);
+    delayOpBox.addItem("x & delayed", static_cast<int>(BitDelay::Op::andOp) + 1);
+    delayOpBox.addItem("x | delayed", static_cast<int>(BitDelay::Op::orOp) + 1);
+    delayOpBox.setSelectedId(static_cast<int>(audioProcessor.ed.getDelayOp()) + 1, dontSendNotification);
+    delayOpBox.addListener(this);
+
+    delayFeedbackButton.setButtonText("feedback");
+    delayFeedbackButton.setToggleState(audioProcessor.ed.getDelayFeedback(), dontSendNotification);
+    delayFeedbackButton.addListener(this);
+
+    delaySlider.setRange({0.0, BitDelay::maxDelaySeconds}, 0.00001);
+    delaySlider.setSkewFactorFromMidPoint(0.05);
+    delaySlider.setTextValueSuffix(" s");
+    delaySlider.addListener(this);
+    delaySlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    delaySlider.setTextBoxIsEditable(true);
+    delaySlider.setValue(audioProcessor.ed.getDelaySeconds(), dontSendNotification);
+
+    delayLabel.setText("delay", dontSendNotification);
+    delayLabel.attachToComponent(&delayOpBox, true);
+
+    addAndMakeVisible(delayOpBox);
+    addAndMakeVisible(delayFeedbackButton);
+    addAndMakeVisible(delaySlider);
+
+    crossModeBox.addItem("no channel swap", static_cast<int>(ChannelBitMixer::Mode::off) + 1);
+    crossModeBox.addItem("rotate", static_cast<int>(ChannelBitMixer::Mode::rotate) + 1);
+    crossModeBox.addItem("copy from", static_cast<int>(ChannelBitMixer::Mode::copy) + 1);
+    crossModeBox.addItem("interleave", static_cast<int>(ChannelBitMixer::Mode::interleave) + 1);
+    crossModeBox.setSelectedId(static_cast<int>(audioProcessor.ed.getCrossMode()) + 1, dontSendNotification);
+    crossModeBox.addListener(this);
+
+    crossOffsetSlider.setRange({0.0, 63.0}, 1.0);
+    crossOffsetSlider.setSliderStyle(juce::Slider::IncDecButtons);
+    crossOffsetSlider.setValue(audioProcessor.ed.getCrossOffset(), dontSendNotification);
+    crossOffsetSlider.addListener(this);
+
+    crossLabel.setText("channels", dontSendNotification);
+    crossLabel.attachToComponent(&crossModeBox, true);
+
+    addAndMakeVisible(crossModeBox);
+    addAndMakeVisible(crossOffsetSlider);
+
+    flipSlider.setRange({0.0, 1.0}, 0.000001);
+    flipSlider.setSkewFactorFromMidPoint(0.01);
+    flipSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    flipSlider.setTextBoxIsEditable(true);
+    flipSlider.setDoubleClickReturnValue(true, 0.0);
+    flipSlider.setValue(flipamount, dontSendNotification);
+    flipSlider.addListener(this);
+
+    flipLabel.setText("bit flips", dontSendNotification);
+    flipLabel.attachToComponent(&flipSlider, true);
+
+    addAndMakeVisible(flipSlider);
+
+    floatModeButton.setButtonText("float32");
+    floatModeButton.setToggleState(audioProcessor.ed.getFloatMode(), dontSendNotification);
+    floatModeButton.addListener(this);
+
+    // one editor for the three 32-bit masks; the box picks which one it's showing
+    floatMaskBox.addItem("and", 1);
+    floatMaskBox.addItem("or", 2);
+    floatMaskBox.addItem("xor", 3);
+    floatMaskBox.setSelectedId(3, dontSendNotification);
+    floatMaskBox.addListener(this);
+
+    floatMaskEditor.addListener(this);
+    floatMaskEditor.setMultiLine(false);
+    floatMaskEditor.setInputFilter(new TextEditor::LengthAndCharacterRestriction(32, "01"), true);
+    showFloatMask();
+
+    // where each of the 32 float bits goes, one base-32 digit per bit like the integer remap
+    floatRemapEditor.addListener(this);
+    floatRemapEditor.setMultiLine(false);
+    floatRemapEditor.setInputFilter(new TextEditor::LengthAndCharacterRestriction(32, floatRemapDigits + floatRemapDigits.toLowerCase()), true);
+    floatRemapEditor.setTextToShowWhenEmpty(floatRemapDigits, juce::Colours::grey);
+    showFloatRemap();
+
+    floatRemapLabel.setText("float remap", dontSendNotification);
+    floatRemapLabel.attachToComponent(&floatRemapEditor, true);
+
+    addAndMakeVisible(floatModeButton);
+    addAndMakeVisible(floatMaskBox);
+    addAndMakeVisible(floatMaskEditor);
+    addAndMakeVisible(floatRemapEditor);
+
     for(Label* a : labels)
     {
         addAndMakeVisible(a);
@@ -130,17 +259,47 @@ void bittyAudioProcessorEditor::textEditorReturnKeyPressed(TextEditor& t)
     if (&t == &xorMaskEditor)
     {
         s = s.paddedRight('0', N_BITS);
-        _p->ed.setxormask(s);
+        _p->ed.setxormask(s, editedBand());
     }
     else if (&t == &andMaskEditor)
     {
         s = s.paddedRight('1', N_BITS);
-        _p->ed.setandmask(s);
+        _p->ed.setandmask(s, editedBand());
     }
     else if (&t == &orMaskEditor)
     {
         s = s.paddedRight('0', N_BITS);
-        _p->ed.setormask(s);
+        _p->ed.setormask(s, editedBand());
+    }
+    else if (&t == &floatMaskEditor)
+    {
+        switch (floatMaskBox.getSelectedId())
+        {
+            case 1: _p->ed.setfloatandmask(s.paddedRight('1', 32)); break;
+            case 2: _p->ed.setfloatormask(s.paddedRight('0', 32)); break;
+            case 3: _p->ed.setfloatxormask(s.paddedRight('0', 32)); break;
+            default: break;
+        }
+    }
+    else if (&t == &floatRemapEditor)
+    {
+        // whatever's missing off the end stays where it is
+        s = s.toUpperCase() + floatRemapDigits.substring(s.length());
+
+        std::array<uint8, 32> arr;
+        for (int i = 0; i < 32; ++i)
+            arr[static_cast<size_t>(i)] = static_cast<uint8>(jmax(0, floatRemapDigits.indexOfChar(s[i])));
+
+        _p->ed.setEntireFloatBitRemap(arr);
+    }
+    else if (&t == &flipBitsEditor)
+    {
+        applyFlips();
+    }
+    else if (&t == &crossMaskEditor)
+    {
+        s = s.paddedRight('0', N_BITS);
+        _p->ed.setCrossMask(s);
     }
     else if (&t == &bitRemapEditor)
     {
@@ -171,7 +330,15 @@ void bittyAudioProcessorEditor::textEditorReturnKeyPressed(TextEditor& t)
             s = s.substring(1);
         }
 
-        _p->ed.setEntireBitRemap(arr);
+        _p->ed.setEntireBitRemap(arr, editedBand());
+    }
+    else if (&t == &expressionEditor)
+    {
+        Result r = _p->ed.setExpression(s);
+
+        // leave the text alone so it can be fixed; just flag it
+        t.setColour(TextEditor::outlineColourId, r.wasOk() ? getLookAndFeel().findColour(TextEditor::outlineColourId) : juce::Colours::red);
+        t.setTooltip(r.getErrorMessage());
     }
 
 
@@ -209,19 +376,50 @@ void bittyAudioProcessorEditor::resized()
     Rectangle<int> remaparea = thesebounds.removeFromTop(thesebounds.proportionOfHeight(0.33)).reduced(5, 5);
     Rectangle<int> maskarea = thesebounds.reduced(5,5);
 
-    bitremapLabel.setBounds(remaparea.removeFromTop(20));
+    Rectangle<int> remaptop = remaparea.removeFromTop(20);
+    programChangeButton.setBounds(remaptop.removeFromRight(200));
+    bitremapLabel.setBounds(remaptop);
     remaparea.removeFromTop(10);
     bitRemapEditor.setBounds(remaparea);
 
-    int areaper = maskarea.proportionOfHeight(0.25);
+    int areaper = maskarea.proportionOfHeight(1.0 / 11.0);
     andMaskEditor.setBounds(maskarea.removeFromTop(areaper).reduced(0, 10).removeFromRight(300));
     orMaskEditor.setBounds(maskarea.removeFromTop(areaper).reduced(0, 10).removeFromRight(300));
     xorMaskEditor.setBounds(maskarea.removeFromTop(areaper).reduced(0, 10).removeFromRight(300));
+    expressionEditor.setBounds(maskarea.removeFromTop(areaper).reduced(0, 10).removeFromRight(300));
 
     auto a = maskarea.removeFromTop(areaper).reduced(0, 10);
     entropySlider.setBounds(a.removeFromRight(150));
     entropyAmtSlider.setBounds(a);
 
+    auto d = maskarea.removeFromTop(areaper).reduced(0, 10).removeFromRight(300);
+    delayOpBox.setBounds(d.removeFromLeft(100));
+    delayFeedbackButton.setBounds(d.removeFromLeft(80));
+    delaySlider.setBounds(d);
+
+    auto n = maskarea.removeFromTop(areaper).reduced(0, 10);
+    flipBitsEditor.setBounds(n.removeFromRight(300));
+    flipSlider.setBounds(n.removeFromRight(jmax(0, n.getWidth() - 80)));
+
+    auto c = maskarea.removeFromTop(areaper).reduced(0, 10).removeFromRight(300);
+    crossModeBox.setBounds(c.removeFromLeft(100));
+    crossOffsetSlider.setBounds(c.removeFromRight(80));
+    crossMaskEditor.setBounds(c);
+
+    auto f = maskarea.removeFromTop(areaper).reduced(0, 10);
+    floatModeButton.setBounds(f.removeFromLeft(80));
+    f = f.removeFromRight(300);
+    floatMaskBox.setBounds(f.removeFromLeft(60));
+    floatMaskEditor.setBounds(f);
+    floatRemapEditor.setBounds(maskarea.removeFromTop(areaper).reduced(0, 10).removeFromRight(300));
+
+    auto b = maskarea.removeFromTop(areaper).reduced(0, 5);
+    b.removeFromLeft(80);
+    numBandsBox.setBounds(b.removeFromLeft(80).reduced(0, 5));
+    editBandBox.setBounds(b.removeFromLeft(110).reduced(5, 5));
+    const int sliderWidth = b.getWidth() / BandSplitter::maxCrossovers;
+    for (Slider& x : crossoverSliders) x.setBounds(b.removeFromLeft(sliderWidth));
+
 
 }
 
@@ -236,4 +434,118 @@ void bittyAudioProcessorEditor::sliderValueChanged(Slider *s)
     {
         _p->ed.setEntropyAmt(entropyAmtSlider.getValue());
     }
+    if (s == &delaySlider)
+    {
+        _p->ed.setDelaySeconds(delaySlider.getValue());
+    }
+    if (s == &crossOffsetSlider)
+    {
+        _p->ed.setCrossOffset(static_cast<int>(crossOffsetSlider.getValue()));
+    }
+    if (s == &flipSlider)
+    {
+        applyFlips();
+    }
+    for (int i = 0; i < BandSplitter::maxCrossovers; ++i)
+    {
+        if (s == &crossoverSliders[static_cast<size_t>(i)])
+        {
+            _p->ed.setCrossover(i, static_cast<float>(s->getValue()));
+        }
+    }
+}
+
+void bittyAudioProcessorEditor::comboBoxChanged(ComboBox *b)
+{
+    if (b == &delayOpBox)
+    {
+        _p->ed.setDelayOp(static_cast<BitDelay::Op>(delayOpBox.getSelectedId() - 1));
+    }
+    if (b == &floatMaskBox)
+    {
+        showFloatMask();
+    }
+    if (b == &crossModeBox)
+    {
+        _p->ed.setCrossMode(static_cast<ChannelBitMixer::Mode>(crossModeBox.getSelectedId() - 1));
+    }
+    if (b == &numBandsBox)
+    {
+        _p->ed.setNumBands(numBandsBox.getSelectedId());
+    }
+    if (b == &editBandBox)
+    {
+        showBand();
+    }
+}
+
+void bittyAudioProcessorEditor::buttonClicked(Button *b)
+{
+    if (b == &delayFeedbackButton)
+    {
+        _p->ed.setDelayFeedback(delayFeedbackButton.getToggleState());
+    }
+    if (b == &floatModeButton)
+    {
+        _p->ed.setFloatMode(floatModeButton.getToggleState());
+    }
+    if (b == &programChangeButton)
+    {
+        _p->ed.setProgramChangeRemaps(programChangeButton.getToggleState());
+    }
+}
+
+void bittyAudioProcessorEditor::showFloatMask()
+{
+    switch (floatMaskBox.getSelectedId())
+    {
+        case 1: floatMaskEditor.setText(audioProcessor.ed.getfloatandmask(), false); break;
+        case 2: floatMaskEditor.setText(audioProcessor.ed.getfloatormask(), false); break;
+        case 3: floatMaskEditor.setText(audioProcessor.ed.getfloatxormask(), false); break;
+        default: break;
+    }
+}
+
+void bittyAudioProcessorEditor::showFloatRemap()
+{
+    String floatremaptext;
+    for (uint8 v : audioProcessor.ed.getfloatbitremap())
+        floatremaptext += floatRemapDigits[jmin(static_cast<int>(v), 31)];
+
+    floatRemapEditor.setText(floatremaptext, false);
+}
+
+void bittyAudioProcessorEditor::showBand()
+{
+    const int band = editedBand();
+    String bitremaptext;
+
+    for (int i = 0; i < N_BITS; ++i)
+    {
+        int bitremapfori = static_cast<int>(audioProcessor.ed.getbitremap(band)[i]);
+        if (bitremapfori < 9)
+        {
+            bitremaptext += bitremapfori;
+        }
+        else
+        {
+            bitremaptext += String::toHexString(bitremapfori);
+        }
+    }
+
+    xorMaskEditor.setText(audioProcessor.ed.getxormask(band), false);
+    orMaskEditor.setText(audioProcessor.ed.getormask(band), false);
+    andMaskEditor.setText(audioProcessor.ed.getandmask(band), false);
+    bitRemapEditor.setText(bitremaptext, false);
+}
+
+void bittyAudioProcessorEditor::applyFlips()
+{
+    String s = flipBitsEditor.getText().paddedRight('0', N_BITS);
+    const float p = static_cast<float>(flipSlider.getValue());
+
+    for (int i = 0; i < N_BITS; ++i)
+    {
+        _p->ed.setFlipProbability(N_BITS - 1 - i, s.substring(i, i + 1) == "1" ? p : 0.0f);
+    }
 }
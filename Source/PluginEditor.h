@@ -19,7 +19,7 @@
 //==============================================================================
 /**
 */
-class bittyAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::TextEditor::Listener, public juce::Slider::Listener
+class bittyAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::TextEditor::Listener, public juce::Slider::Listener, public juce::ComboBox::Listener, public juce::Button::Listener
 {
 
     bittyAudioProcessor& audioProcessor;
@@ -36,6 +36,8 @@ public:
 
 
     void sliderValueChanged (Slider *slider) override;
+    void comboBoxChanged (ComboBox *box) override;
+    void buttonClicked (Button *button) override;
 
 private:
     // This reference is provided as a quick way for your editor to
@@ -49,17 +51,41 @@ private:
 
     Slider entropySlider;
     Slider entropyAmtSlider;
+    Slider delaySlider;
+    Slider crossOffsetSlider;
+    Slider flipSlider;
+
+    ComboBox delayOpBox;
+    ComboBox crossModeBox;
+    ComboBox floatMaskBox;
+    ComboBox numBandsBox;
+    ComboBox editBandBox;
+    std::array<Slider, BandSplitter::maxCrossovers> crossoverSliders;
+    ToggleButton delayFeedbackButton;
+    ToggleButton floatModeButton;
+    ToggleButton programChangeButton;
+
+    void showFloatMask();
+    void showFloatRemap();
+    void showBand();
+    int editedBand() const { return jmax(0, editBandBox.getSelectedId() - 1); }
+    void applyFlips();
 
     TextEditor andMaskEditor;
     TextEditor orMaskEditor;
     TextEditor xorMaskEditor;
     TextEditor bitRemapEditor;
+    TextEditor expressionEditor;
+    TextEditor crossMaskEditor;
+    TextEditor floatMaskEditor;
+    TextEditor floatRemapEditor;
+    TextEditor flipBitsEditor;
 
-    std::array<TextEditor*, 4> editors = {&andMaskEditor, &orMaskEditor, &xorMaskEditor, &bitRemapEditor};
+    std::array<TextEditor*, 6> editors = {&andMaskEditor, &orMaskEditor, &xorMaskEditor, &bitRemapEditor, &crossMaskEditor, &flipBitsEditor};
 
-    Label andLabel, orLabel, xorLabel, bitremapLabel, removeDenormalsLabel, entropySliderLabel;
+    Label andLabel, orLabel, xorLabel, bitremapLabel, removeDenormalsLabel, entropySliderLabel, expressionLabel, delayLabel, crossLabel, bandsLabel, flipLabel, floatRemapLabel;
 
-    std::array<Label*, 6> labels = {&andLabel, &orLabel, &xorLabel, &bitremapLabel, &removeDenormalsLabel, &entropySliderLabel};
+    std::array<Label*, 12> labels = {&andLabel, &orLabel, &xorLabel, &bitremapLabel, &removeDenormalsLabel, &entropySliderLabel, &expressionLabel, &delayLabel, &crossLabel, &bandsLabel, &flipLabel, &floatRemapLabel};
 
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (bittyAudioProcessorEditor)
@@ -23,11 +23,27 @@ bittyAudioProcessor::bittyAudioProcessor()
                        )
 #endif
 {
-
+   #if BITTY_TRACING
+    // plugins share the host's process, so only the standalone traces by default
+    if (wrapperType == wrapperType_Standalone)
+        bittytrace::Tracer::start(getTraceFile());
+   #endif
 }
 
 bittyAudioProcessor::~bittyAudioProcessor()
 {
+   #if BITTY_TRACING
+    if (wrapperType == wrapperType_Standalone)
+        bittytrace::Tracer::stop();
+   #endif
+}
+
+File bittyAudioProcessor::getTraceFile()
+{
+    String path = SystemStats::getEnvironmentVariable("BITTY_TRACE_FILE", {});
+    if (path.isNotEmpty() && File::isAbsolutePath(path)) return File(path);
+
+    return File::getSpecialLocation(File::userDesktopDirectory).getChildFile("bitty-trace.json");
 }
 
 //==============================================================================
@@ -114,10 +130,9 @@ bool bittyAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // anything up to the engine's 64 channels; the channel bit mixer wants quad and up.
+    if (layouts.getMainOutputChannelSet().isDisabled()
+     || layouts.getMainOutputChannelSet().size() > 64)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -134,13 +149,20 @@ bool bittyAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) co
 void bittyAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    BITTY_TRACE_SCOPE("processBlock");
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    ed.processSamplesContextReplacing(buffer);
+    AudioPlayHead::CurrentPositionInfo position;
+    if (auto* playHead = getPlayHead())
+        if (playHead->getCurrentPosition(position) && position.isPlaying)
+            ed.syncNoiseClock(position.timeInSamples);
+
+    ed.processSamplesContextReplacing(buffer, midiMessages);
 
 }
 
@@ -165,27 +187,7 @@ void bittyAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     // as intermediaries to make it easy to save and load complex data.
 
 
-    ValueTree vt("settings");
-
-
-    vt.setProperty("version", "0.0.0", nullptr);
-    vt.setProperty("license", "GNU Affero General Public License v3.0", nullptr);
-
-    vt.setProperty("xormask", ed.getxormask(), nullptr);
-    vt.setProperty("ormask", ed.getormask(), nullptr);
-    vt.setProperty("andmask", ed.getandmask(), nullptr);
-
-    String remapvalsString = "";
-
-    for (int i = 0; i < N_BITS; ++i)
-    {
-        remapvalsString.append(String(static_cast<char>(ed.getbitremap()[i])), 1);
-    }
-
-    vt.setProperty("remapvals", remapvalsString, nullptr);
-
-
-    std::unique_ptr<XmlElement> a = vt.createXml();
+    std::unique_ptr<XmlElement> a = ed.getState().createXml();
 
 
     copyXmlToBinary(*a, destData);
@@ -206,29 +208,7 @@ void bittyAudioProcessor::setStateInformation (const void* data, int sizeInBytes
 
     if (! xml->hasTagName("settings")) return;
 
-    ValueTree vt("settings");
-    vt = ValueTree::fromXml(*xml);
-
-
-    String test = vt.toXmlString();
-
-
-    ed.setxormask(vt.getProperty("xormask"));
-    ed.setormask(vt.getProperty("ormask"));
-    ed.setandmask(vt.getProperty("andmask"));
-
-    std::array<uint8, N_BITS> bits;
-
-    String s = vt.getProperty("remapvals");
-
-    for (int i = 0; i < N_BITS; ++i)
-    {
-        bits[i] = static_cast<uint8>(s.substring(i,i+1).getIntValue());
-    }
-
-    ed.setEntireBitRemap(bits);
-
-
+    ed.setState(ValueTree::fromXml(*xml));
 }
 
 
@@ -12,6 +12,7 @@
 
 #include <JuceHeader.h>
 #include "Engine.h"
+#include "Trace.h"
 
 //==============================================================================
 /**
@@ -60,6 +61,9 @@ public:
 
     BitmaskerEngine ed;
 
+    /** where the chrome trace goes when built with BITTY_TRACING: $BITTY_TRACE_FILE, else the desktop. */
+    static File getTraceFile();
+
 private:
 
 
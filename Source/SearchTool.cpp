@@ -0,0 +1,500 @@
+/*
+  ==============================================================================
+
+    SearchTool.cpp
+    Created: 19 Oct 2026 8:51:37pm
+    Author:  Zachary Lewis-Towbes
+
+    bitty_search: offline evolutionary search over masks and remaps for
+    settings whose output matches a target, written out as presets.
+
+        bitty_search source.wav --reference ref.wav   match ref's spectral envelope
+        bitty_search source.wav --crest 12            crest factor in dB
+        bitty_search source.wav --harshness -8        2-6k energy vs total, in dB
+
+    options: --generations N (50), --population N (64), --top N (5),
+             --seconds S (20), --seed N, --out dir (.), --threads N (all),
+             --trace file.json (BITTY_TRACING builds)
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "Engine.h"
+#include "Trace.h"
+
+#include <iostream>
+#include <limits>
+
+
+namespace
+{
+
+//==============================================================================
+struct Candidate
+{
+    std::bitset<N_BITS> andmask, ormask, xormask;
+    std::array<uint8, N_BITS> remap;
+    double score = std::numeric_limits<double>::max();
+    bool scored = false;
+};
+
+
+/** power spectrum based measurements, one instance per worker thread since the fft isn't shareable. */
+class Analyser
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBands = 32;
+
+    explicit Analyser(double sr)
+        : sampleRate(sr), fft(fftOrder), window(fftSize, dsp::WindowingFunction<float>::hann),
+          frame(2 * fftSize), power(fftSize / 2 + 1)
+    {
+    }
+
+    /** average power per bin over the whole signal. */
+    void measure(const float* mono, int n)
+    {
+        std::fill(power.begin(), power.end(), 0.0);
+        int frames = 0;
+
+        for (int start = 0; start + fftSize <= n; start += fftSize / 2, ++frames)
+        {
+            std::copy(mono + start, mono + start + fftSize, frame.begin());
+            std::fill(frame.begin() + fftSize, frame.end(), 0.0f);
+            window.multiplyWithWindowingTable(frame.data(), fftSize);
+            fft.performFrequencyOnlyForwardTransform(frame.data());
+
+            for (size_t bin = 0; bin < power.size(); ++bin)
+                power[bin] += static_cast<double>(frame[bin]) * frame[bin];
+        }
+
+        if (frames > 0)
+            for (auto& p : power) p /= frames;
+    }
+
+    /** log-spaced bands from 40 Hz to nyquist, in dB. */
+    std::array<double, numBands> envelope() const
+    {
+        std::array<double, numBands> bands;
+        const double lo = 40.0, hi = sampleRate / 2.0;
+
+        for (int b = 0; b < numBands; ++b)
+        {
+            const double f0 = lo * std::pow(hi / lo, static_cast<double>(b) / numBands);
+            const double f1 = lo * std::pow(hi / lo, static_cast<double>(b + 1) / numBands);
+            bands[static_cast<size_t>(b)] = Decibels::gainToDecibels(std::sqrt(bandPower(f0, f1) + 1e-20), -200.0);
+        }
+
+        return bands;
+    }
+
+    double harshness() const
+    {
+        return 10.0 * std::log10((bandPower(2000.0, 6000.0) + 1e-20) / (bandPower(0.0, sampleRate / 2.0) + 1e-20));
+    }
+
+    static double crest(const float* mono, int n)
+    {
+        double peak = 0, sum = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            peak = jmax(peak, static_cast<double>(std::abs(mono[i])));
+            sum += static_cast<double>(mono[i]) * mono[i];
+        }
+
+        const double rms = std::sqrt(sum / jmax(1, n));
+        return Decibels::gainToDecibels((peak + 1e-12) / (rms + 1e-12));
+    }
+
+private:
+    double bandPower(double f0, double f1) const
+    {
+        const double binWidth = sampleRate / fftSize;
+        const int b0 = jlimit(0, static_cast<int>(power.size()) - 1, static_cast<int>(f0 / binWidth));
+        const int b1 = jlimit(b0 + 1, static_cast<int>(power.size()), static_cast<int>(f1 / binWidth) + 1);
+
+        double p = 0;
+        for (int b = b0; b < b1; ++b) p += power[static_cast<size_t>(b)];
+        return p;
+    }
+
+    double sampleRate;
+    dsp::FFT fft;
+    dsp::WindowingFunction<float> window;
+    std::vector<float> frame;
+    std::vector<double> power;
+};
+
+
+//==============================================================================
+struct Target
+{
+    enum class Kind { reference, crest, harshness } kind = Kind::reference;
+    double value = 0;
+    std::array<double, Analyser::numBands> envelope {};
+};
+
+
+/** renders one candidate over the pre-converted source and scores it. lower is better. */
+class Evaluator
+{
+public:
+    Evaluator(const std::vector<BitWord>& src, double sr, const Target& t)
+        : source(src), target(t), analyser(sr), words(src.size()), rendered(src.size())
+    {
+    }
+
+    double evaluate(const Candidate& c)
+    {
+        BITTY_TRACE_SCOPE("evaluate");
+
+        BitExpression none;
+        auto table = TransformTable::build(none, c.remap, c.andmask, c.ormask, c.xormask);
+
+        std::copy(source.begin(), source.end(), words.begin());
+        table->process(words.data(), static_cast<int>(words.size()));
+
+        AudioData::Pointer<AudioData::Float32, AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::NonConst> dst(rendered.data());
+        AudioData::Pointer<
+#if N_BITS == 8
+                            AudioData::Int8,
+#elif N_BITS == 16
+                            AudioData::Int16,
+#endif
+                            AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::Const> in(words.data());
+        dst.convertSamples(in, static_cast<int>(words.size()));
+
+        const int n = static_cast<int>(rendered.size());
+
+        switch (target.kind)
+        {
+            case Target::Kind::crest:
+                return std::abs(Analyser::crest(rendered.data(), n) - target.value);
+
+            case Target::Kind::harshness:
+                analyser.measure(rendered.data(), n);
+                return std::abs(analyser.harshness() - target.value);
+
+            case Target::Kind::reference:
+            {
+                analyser.measure(rendered.data(), n);
+                auto env = analyser.envelope();
+
+                double d = 0;
+                for (size_t b = 0; b < env.size(); ++b)
+                {
+                    const double diff = jmax(env[b], -120.0) - jmax(target.envelope[b], -120.0);
+                    d += diff * diff;
+                }
+                return std::sqrt(d / static_cast<double>(env.size()));
+            }
+        }
+
+        return std::numeric_limits<double>::max();
+    }
+
+private:
+    const std::vector<BitWord>& source;
+    const Target& target;
+    Analyser analyser;
+    std::vector<BitWord> words;
+    std::vector<float> rendered;
+};
+
+
+//==============================================================================
+bool loadMono(const File& f, double maxSeconds, std::vector<float>& mono, double& sampleRate)
+{
+    AudioFormatManager fm;
+    fm.registerBasicFormats();
+
+    std::unique_ptr<AudioFormatReader> reader(fm.createReaderFor(f));
+    if (reader == nullptr) return false;
+
+    sampleRate = reader->sampleRate;
+    const int len = static_cast<int>(jmin<int64>(reader->lengthInSamples, static_cast<int64>(maxSeconds * sampleRate)));
+
+    AudioBuffer<float> buf(static_cast<int>(reader->numChannels), len);
+    reader->read(&buf, 0, len, 0, true, true);
+
+    mono.assign(static_cast<size_t>(len), 0.0f);
+    for (int ch = 0; ch < buf.getNumChannels(); ++ch)
+        FloatVectorOperations::addWithMultiply(mono.data(), buf.getReadPointer(ch), 1.0f / buf.getNumChannels(), len);
+
+    return len > 0;
+}
+
+Candidate identity()
+{
+    Candidate c;
+    c.andmask.set();
+    for (uint8 i = 0; i < N_BITS; ++i) c.remap[i] = i;
+    return c;
+}
+
+void mutate(Candidate& c, Random& rng)
+{
+    const int count = 1 + rng.nextInt(3);
+
+    for (int m = 0; m < count; ++m)
+    {
+        const int bit = rng.nextInt(N_BITS);
+
+        switch (rng.nextInt(4))
+        {
+            case 0: c.andmask.flip(static_cast<size_t>(bit)); break;
+            case 1: c.ormask.flip(static_cast<size_t>(bit)); break;
+            case 2: c.xormask.flip(static_cast<size_t>(bit)); break;
+            default: std::swap(c.remap[static_cast<size_t>(bit)], c.remap[static_cast<size_t>(rng.nextInt(N_BITS))]); break;
+        }
+    }
+
+    c.score = std::numeric_limits<double>::max();
+    c.scored = false;
+}
+
+Candidate randomCandidate(Random& rng)
+{
+    // biased towards "mostly intact" so the first generation isn't all noise
+    Candidate c = identity();
+
+    for (int b = 0; b < N_BITS; ++b)
+    {
+        if (rng.nextFloat() < 0.2f) c.andmask.reset(static_cast<size_t>(b));
+        if (rng.nextFloat() < 0.08f) c.ormask.set(static_cast<size_t>(b));
+        if (rng.nextFloat() < 0.12f) c.xormask.set(static_cast<size_t>(b));
+    }
+
+    for (int s = rng.nextInt(5); s > 0; --s)
+        std::swap(c.remap[static_cast<size_t>(rng.nextInt(N_BITS))], c.remap[static_cast<size_t>(rng.nextInt(N_BITS))]);
+
+    return c;
+}
+
+/** the evaluators and the threads they run on, made once for the whole search.
+    threads made per generation would each take a new trace ring, and there are
+    only Tracer::maxThreads of those. */
+class Workers
+{
+public:
+    Workers(int numThreads, const std::vector<BitWord>& source, double sr, const Target& target)
+        : pool(numThreads)
+    {
+        for (int t = 0; t < numThreads; ++t)
+            jobs.push_back(std::make_unique<Job>(*this, std::make_unique<Evaluator>(source, sr, target)));
+    }
+
+    /** scores every candidate without one, spread over the evaluators. */
+    void evaluateAll(std::vector<Candidate>& candidates)
+    {
+        population = &candidates;
+        next = 0;
+
+        for (auto& j : jobs) pool.addJob(j.get(), false);
+        for (auto& j : jobs) pool.waitForJobToFinish(j.get(), -1);
+    }
+
+private:
+    class Job : public ThreadPoolJob
+    {
+    public:
+        Job(Workers& w, std::unique_ptr<Evaluator> e) : ThreadPoolJob("evaluate"), owner(w), evaluator(std::move(e)) {}
+
+        JobStatus runJob() override
+        {
+            std::vector<Candidate>& population = *owner.population;
+
+            for (size_t i = owner.next++; i < population.size(); i = owner.next++)
+            {
+                if (! population[i].scored)
+                {
+                    population[i].score = evaluator->evaluate(population[i]);
+                    population[i].scored = true;
+                }
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        Workers& owner;
+        std::unique_ptr<Evaluator> evaluator;
+    };
+
+    std::vector<std::unique_ptr<Job>> jobs; // declared before the pool so the pool and its threads go first
+    ThreadPool pool;
+    std::vector<Candidate>* population = nullptr;
+    std::atomic<size_t> next { 0 };
+};
+
+bool writePreset(const Candidate& c, const File& file)
+{
+    BitmaskerEngine engine;
+    engine.setandmask(String(c.andmask.to_string()));
+    engine.setormask(String(c.ormask.to_string()));
+    engine.setxormask(String(c.xormask.to_string()));
+    engine.setEntireBitRemap(c.remap);
+
+    auto xml = engine.getState().createXml();
+    return xml != nullptr && xml->writeTo(file);
+}
+
+/** stops the trace however main returns, so the file always ends as valid json. */
+struct TraceSession
+{
+    explicit TraceSession(const ArgumentList& args)
+    {
+       #if BITTY_TRACING
+        if (args.containsOption("--trace"))
+            bittytrace::Tracer::start(args.getFileForOption("--trace"));
+       #else
+        ignoreUnused(args);
+       #endif
+    }
+
+    ~TraceSession()
+    {
+       #if BITTY_TRACING
+        bittytrace::Tracer::stop();
+       #endif
+    }
+};
+
+int fail(const String& message)
+{
+    std::cerr << "bitty_search: " << message << std::endl;
+    return 1;
+}
+
+} // namespace
+
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        std::cout << "usage: bitty_search source.wav (--reference ref.wav | --crest dB | --harshness dB) [options]" << std::endl;
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    auto option = [&args] (const char* name, double fallback)
+    {
+        return args.containsOption(name) ? args.getValueForOption(name).getDoubleValue() : fallback;
+    };
+
+    const double seconds = option("--seconds", 20.0);
+    const int generations = jmax(1, static_cast<int>(option("--generations", 50)));
+    const int populationSize = jmax(4, static_cast<int>(option("--population", 64)));
+    const int top = jlimit(1, populationSize, static_cast<int>(option("--top", 5)));
+    const int numThreads = jmax(1, static_cast<int>(option("--threads", SystemStats::getNumCpus())));
+    const bool seeded = args.containsOption("--seed");
+    const int64 seed = seeded ? args.getValueForOption("--seed").getLargeIntValue() : Time::currentTimeMillis();
+
+    // without it a run that found something good couldn't be repeated
+    if (! seeded) std::cout << "seed " << seed << std::endl;
+
+    TraceSession trace(args);
+
+    std::vector<float> sourceMono;
+    double sampleRate = 0;
+    if (! loadMono(args[0].resolveAsFile(), seconds, sourceMono, sampleRate))
+        return fail("couldn't read " + args[0].text);
+
+    Target target;
+    if (args.containsOption("--reference"))
+    {
+        std::vector<float> refMono;
+        double refRate = 0;
+        if (! loadMono(args.getFileForOption("--reference"), seconds, refMono, refRate))
+            return fail("couldn't read the reference file");
+
+        Analyser a(refRate);
+        a.measure(refMono.data(), static_cast<int>(refMono.size()));
+        target.kind = Target::Kind::reference;
+        target.envelope = a.envelope();
+    }
+    else if (args.containsOption("--crest"))
+    {
+        target.kind = Target::Kind::crest;
+        target.value = option("--crest", 0);
+    }
+    else if (args.containsOption("--harshness"))
+    {
+        target.kind = Target::Kind::harshness;
+        target.value = option("--harshness", 0);
+    }
+    else return fail("need one of --reference, --crest or --harshness");
+
+    // convert once; every candidate starts from the same integer words
+    std::vector<BitWord> sourceWords(sourceMono.size());
+    {
+        AudioData::Pointer<AudioData::Float32, AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::Const> in(sourceMono.data());
+        AudioData::Pointer<
+#if N_BITS == 8
+                            AudioData::Int8,
+#elif N_BITS == 16
+                            AudioData::Int16,
+#endif
+                            AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::NonConst> dst(sourceWords.data());
+        dst.convertSamples(in, static_cast<int>(sourceMono.size()));
+    }
+
+    Workers workers(numThreads, sourceWords, sampleRate, target);
+
+    // all the randomness happens here on the main thread, so a seed always gives the same result
+    Random rng(seed);
+    std::vector<Candidate> population;
+    population.push_back(identity());
+    while (static_cast<int>(population.size()) < populationSize)
+        population.push_back(randomCandidate(rng));
+
+    const int survivors = jmax(1, populationSize / 4);
+    auto byScore = [] (const Candidate& a, const Candidate& b) { return a.score < b.score; };
+
+    for (int gen = 0; gen < generations; ++gen)
+    {
+        workers.evaluateAll(population);
+        std::sort(population.begin(), population.end(), byScore);
+
+        std::cout << "generation " << gen + 1 << "/" << generations << "  best " << population.front().score << std::endl;
+
+        if (gen + 1 == generations) break;
+
+        // keep the best quarter, refill with mutants of them plus a few fresh ones to stay out of local minima
+        for (int i = survivors; i < populationSize; ++i)
+        {
+            if (i >= populationSize - populationSize / 8)
+            {
+                population[static_cast<size_t>(i)] = randomCandidate(rng);
+            }
+            else
+            {
+                population[static_cast<size_t>(i)] = population[static_cast<size_t>(rng.nextInt(survivors))];
+                mutate(population[static_cast<size_t>(i)], rng);
+            }
+        }
+    }
+
+    const File outDir = args.containsOption("--out") ? args.getFileForOption("--out") : File::getCurrentWorkingDirectory();
+    outDir.createDirectory();
+
+    for (int i = 0; i < top; ++i)
+    {
+        const Candidate& c = population[static_cast<size_t>(i)];
+        const File f = outDir.getChildFile("bitty_search_" + String(i + 1) + ".xml");
+
+        if (! writePreset(c, f)) return fail("couldn't write " + f.getFullPathName());
+
+        std::cout << f.getFileName() << "  score " << c.score
+                  << "  and " << c.andmask.to_string() << "  or " << c.ormask.to_string() << "  xor " << c.xormask.to_string() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+/*
+  ==============================================================================
+
+    TableCache.h
+    Created: 19 Oct 2026 7:26:40pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "TransformTable.h"
+
+
+/**
+    One process-wide pool of transform tables, keyed by their settings, so
+    instances with the same masks/remap/expression share a single table (and
+    the cache lines holding it) instead of each carrying its own copy.
+
+    acquire() runs on whichever thread changes settings and may build a table.
+    A Handle is a plain counted reference: releasing it is one atomic
+    decrement and never frees anything, so it's safe wherever the engine
+    happens to drop one. Unreferenced tables linger for a few seconds in case
+    the same preset comes back, then a background thread frees them. The
+    thread looks once a second; tests can make it look more often.
+
+    Hold the cache through a SharedResourcePointer for as long as any handle
+    from it is alive.
+*/
+class TableCache : private Thread
+{
+    struct Entry;
+
+public:
+    explicit TableCache(int reapIntervalMilliseconds = 1000)
+        : Thread("bitty table reaper"), reapInterval(jmax(1, reapIntervalMilliseconds))
+    {
+        startThread();
+    }
+
+    ~TableCache() override
+    {
+        stopThread(2000);
+
+        for (auto& bucket : entries)
+            for (Entry* e : bucket.second)
+            {
+                jassert(e->refs.load() == 0); // a handle outlived the cache
+                delete e;
+            }
+    }
+
+    //==============================================================================
+    class Handle
+    {
+    public:
+        Handle() = default;
+        ~Handle() { reset(); }
+
+        Handle(Handle&& other) noexcept : entry(other.entry) { other.entry = nullptr; }
+        Handle& operator=(Handle&& other) noexcept
+        {
+            if (this != &other) { reset(); entry = other.entry; other.entry = nullptr; }
+            return *this;
+        }
+
+        const TransformTable* get() const noexcept { return entry != nullptr ? entry->table.get() : nullptr; }
+
+        void reset() noexcept
+        {
+            if (entry != nullptr) entry->refs.fetch_sub(1, std::memory_order_acq_rel);
+            entry = nullptr;
+        }
+
+    private:
+        friend class TableCache;
+        explicit Handle(Entry* e) noexcept : entry(e) {}
+
+        Entry* entry = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE(Handle)
+    };
+
+    struct Stats
+    {
+        int numTables = 0;         // live in the cache, referenced or not
+        int numReferenced = 0;     // currently held by at least one engine
+        int numReferences = 0;     // total handles out
+        size_t bytes = 0;          // table memory owned by the cache
+        int64 hits = 0, misses = 0;
+    };
+
+    //==============================================================================
+    Handle acquire(const BitExpression& expr,
+                   const std::array<uint8, N_BITS>& remap,
+                   std::bitset<N_BITS> andmask,
+                   std::bitset<N_BITS> ormask,
+                   std::bitset<N_BITS> xormask)
+    {
+        Key key { expr.getText(), remap,
+                  static_cast<uint32>(andmask.to_ulong()),
+                  static_cast<uint32>(ormask.to_ulong()),
+                  static_cast<uint32>(xormask.to_ulong()) };
+        const uint64 hash = key.hash();
+
+        {
+            const ScopedLock sl(lock);
+            if (Entry* e = find(hash, key))
+            {
+                ++hits;
+                return grab(e);
+            }
+        }
+
+        // build outside the lock so other instances aren't held up; if one of
+        // them raced us to the same key, theirs wins and ours is dropped
+        auto table = TransformTable::build(expr, remap, andmask, ormask, xormask);
+
+        const ScopedLock sl(lock);
+        if (Entry* e = find(hash, key))
+        {
+            ++hits;
+            return grab(e);
+        }
+
+        ++misses;
+        Entry* e = new Entry { std::move(key), std::move(table) };
+        entries[hash].push_back(e);
+        return grab(e);
+    }
+
+    Stats getStats() const
+    {
+        const ScopedLock sl(lock);
+
+        Stats s;
+        for (auto& bucket : entries)
+            for (Entry* e : bucket.second)
+            {
+                const int r = e->refs.load(std::memory_order_relaxed);
+                ++s.numTables;
+                s.numReferenced += r > 0 ? 1 : 0;
+                s.numReferences += r;
+            }
+
+        s.bytes = static_cast<size_t>(s.numTables) * sizeof(TransformTable);
+        s.hits = hits;
+        s.misses = misses;
+        return s;
+    }
+
+private:
+    // how many reaper passes an unreferenced table survives
+    static constexpr int idlePassesBeforeFree = 10;
+
+    struct Key
+    {
+        String expression;
+        std::array<uint8, N_BITS> remap;
+        uint32 andBits, orBits, xorBits;
+
+        bool operator==(const Key& o) const
+        {
+            return andBits == o.andBits && orBits == o.orBits && xorBits == o.xorBits
+                && remap == o.remap && expression == o.expression;
+        }
+
+        uint64 hash() const
+        {
+            // fnv-1a over everything that goes into the table
+            uint64 h = 0xcbf29ce484222325ull;
+            auto mix = [&h] (const void* data, size_t n)
+            {
+                auto* p = static_cast<const uint8*>(data);
+                for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 0x100000001b3ull; }
+            };
+
+            mix(remap.data(), remap.size());
+            mix(&andBits, sizeof(andBits));
+            mix(&orBits, sizeof(orBits));
+            mix(&xorBits, sizeof(xorBits));
+            mix(expression.toRawUTF8(), expression.getNumBytesAsUTF8());
+            return h;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::unique_ptr<TransformTable> table;
+        std::atomic<int> refs { 0 };
+        int idlePasses = 0;
+    };
+
+    Entry* find(uint64 hash, const Key& key) const
+    {
+        auto it = entries.find(hash);
+        if (it == entries.end()) return nullptr;
+
+        for (Entry* e : it->second)
+            if (e->key == key) return e;
+
+        return nullptr;
+    }
+
+    Handle grab(Entry* e)
+    {
+        // under the lock, which is what keeps the reaper from freeing it between the find and here
+        e->refs.fetch_add(1, std::memory_order_acq_rel);
+        e->idlePasses = 0;
+        return Handle(e);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait(reapInterval);
+            reap();
+        }
+    }
+
+    void reap()
+    {
+        std::vector<Entry*> doomed;
+
+        {
+            const ScopedLock sl(lock);
+
+            for (auto it = entries.begin(); it != entries.end();)
+            {
+                auto& bucket = it->second;
+
+                for (size_t i = 0; i < bucket.size();)
+                {
+                    Entry* e = bucket[i];
+
+                    // refs can only go up under the lock, so a zero here stays zero
+                    if (e->refs.load(std::memory_order_acquire) == 0 && ++e->idlePasses > idlePassesBeforeFree)
+                    {
+                        doomed.push_back(e);
+                        bucket[i] = bucket.back();
+                        bucket.pop_back();
+                    }
+                    else ++i;
+                }
+
+                it = bucket.empty() ? entries.erase(it) : std::next(it);
+            }
+        }
+
+        for (Entry* e : doomed) delete e;
+    }
+
+    const int reapInterval;
+    CriticalSection lock;
+    std::unordered_map<uint64, std::vector<Entry*>> entries;
+    int64 hits = 0, misses = 0;
+};
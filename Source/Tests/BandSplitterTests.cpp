@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    BandSplitterTests.cpp
+    Created: 19 Oct 2026 11:59:48pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <cmath>
+
+#include "TestHelpers.h"
+
+
+/** the crossover bank has to sum back to an allpass: with nothing done to the bands,
+    an impulse split and added up again comes out flat in magnitude at every frequency.
+    covers the packed kernel (a few channels, two or three bands) and the one that
+    runs a channel per lane, in ragged blocks. */
+class BandSplitterTests : public UnitTest
+{
+public:
+    BandSplitterTests() : UnitTest("BandSplitter", "bitty") {}
+
+    void runTest() override
+    {
+        Random r = getRandom();
+
+        for (int numBands = 2; numBands <= BandSplitter::maxBands; ++numBands)
+        {
+            beginTest(String(numBands) + " bands sum flat");
+
+            for (int numChannels : { 1, 2, 3, 5 })
+            {
+                check(r, numBands, numChannels, { 200.0f, 2000.0f, 9000.0f });
+
+                // anywhere in the audible range, typed in any order
+                std::array<float, BandSplitter::maxCrossovers> freqs;
+                for (auto& f : freqs) f = 40.0f * std::pow(400.0f, r.nextFloat());
+                check(r, numBands, numChannels, freqs);
+            }
+        }
+    }
+
+private:
+    static constexpr int numSamples = 8192;
+
+    void check(Random& r, int numBands, int numChannels, std::array<float, BandSplitter::maxCrossovers> freqs)
+    {
+        BandSplitter splitter;
+        splitter.prepare(numChannels, bittytest::sampleRate);
+        splitter.setCrossovers(freqs);
+
+        // an impulse on every channel, a block at a time
+        std::array<AudioBuffer<float>, BandSplitter::maxBands> bands;
+        std::vector<AudioBuffer<float>> responses(static_cast<size_t>(numBands), AudioBuffer<float>(numChannels, numSamples));
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int n = jmin(1 + r.nextInt(bittytest::maxBlockSize), numSamples - start);
+
+            AudioBuffer<float> in(numChannels, n);
+            in.clear();
+            if (start == 0)
+                for (int chan = 0; chan < numChannels; ++chan) in.setSample(chan, 0, 1.0f);
+
+            for (int b = 0; b < numBands; ++b) bands[static_cast<size_t>(b)].setSize(numChannels, n);
+            splitter.process(in, bands, numBands);
+
+            for (int b = 0; b < numBands; ++b)
+                for (int chan = 0; chan < numChannels; ++chan)
+                    responses[static_cast<size_t>(b)].copyFrom(chan, start, bands[static_cast<size_t>(b)], chan, 0, n);
+
+            start += n;
+        }
+
+        std::sort(freqs.begin(), freqs.end());
+        const String what = String(numChannels) + " channels, crossovers " + String(freqs[0]) + " " + String(freqs[1]) + " " + String(freqs[2]);
+
+        AudioBuffer<float> sum(responses[0]);
+        for (int b = 1; b < numBands; ++b)
+            for (int chan = 0; chan < numChannels; ++chan)
+                sum.addFrom(chan, 0, responses[static_cast<size_t>(b)], chan, 0, numSamples);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            float worst = 0;
+            for (double f = 20.0; f < 20000.0; f *= 1.1)
+            {
+                double re = 0, im = 0;
+                addResponse(sum, chan, f, re, im);
+                worst = jmax(worst, static_cast<float>(std::abs(std::sqrt(re * re + im * im) - 1.0)));
+            }
+
+            expectLessOrEqual(worst, 1.0e-3f, "summed magnitude, channel " + String(chan) + ", " + what);
+
+            // and they really are split: the bottom band is gone well above its crossover
+            const double above = 8.0 * freqs[0];
+            if (above < 20000.0)
+            {
+                double re = 0, im = 0;
+                addResponse(responses[0], chan, above, re, im);
+                expectLessOrEqual(std::sqrt(re * re + im * im), 0.01, "bottom band 8x above its crossover, " + what);
+            }
+        }
+    }
+
+    /** adds one channel's response at f hz to re and im, as a plain dft of the impulse response. */
+    static void addResponse(const AudioBuffer<float>& impulseResponse, int chan, double f, double& re, double& im)
+    {
+        const double w = 2.0 * MathConstants<double>::pi * f / bittytest::sampleRate;
+        const float* h = impulseResponse.getReadPointer(chan);
+
+        for (int i = 0; i < impulseResponse.getNumSamples(); ++i)
+        {
+            re += h[i] * std::cos(w * i);
+            im -= h[i] * std::sin(w * i);
+        }
+    }
+};
+
+static BandSplitterTests bandSplitterTests;
@@ -0,0 +1,446 @@
+/*
+  ==============================================================================
+
+    Benchmarks.cpp
+    Created: 19 Oct 2026 11:58:12pm
+    Author:  Zachary Lewis-Towbes
+
+    timings with a budget each, so a change that makes bitty much slower or
+    bigger fails the run instead of going unnoticed. every number is logged.
+    the time budgets are loose enough for a busy machine and only apply to
+    optimised builds; the memory budgets don't depend on either.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "TestHelpers.h"
+
+
+class Benchmark : public UnitTest
+{
+public:
+    explicit Benchmark(const String& testName) : UnitTest(testName, "benchmarks") {}
+
+protected:
+    void expectTimeWithin(double time, double budget, const String& what)
+    {
+       #if JUCE_DEBUG
+        ignoreUnused(time, budget, what);
+       #else
+        expectLessOrEqual(time, budget, what + " is over budget");
+       #endif
+    }
+
+    /** the best of a few renders of a second of the stereo test signal through each
+        prepared engine, in 512 sample blocks, in nanoseconds per sample per channel.
+        the engines take turns each round so a busy moment doesn't favour one. */
+    static std::vector<double> nanosecondsPerSample(const std::vector<BitmaskerEngine*>& engines)
+    {
+        const AudioBuffer<float> signal = bittytest::makeSignal(static_cast<int>(bittytest::sampleRate));
+        AudioBuffer<float> buffer(signal);
+        std::vector<double> best(engines.size(), std::numeric_limits<double>::max());
+
+        for (int round = 0; round < 9; ++round)
+        {
+            for (size_t i = 0; i < engines.size(); ++i)
+            {
+                buffer.makeCopyOf(signal, true);
+                best[i] = jmin(best[i], bittytest::bestMicroseconds(1, [&]
+                {
+                    bittytest::render(*engines[i], buffer, { bittytest::maxBlockSize });
+                }));
+            }
+        }
+
+        for (double& t : best) t *= 1000.0 / (signal.getNumSamples() * signal.getNumChannels());
+        return best;
+    }
+};
+
+//==============================================================================
+/** what a session with a lot of instances pays for each one: the constructor,
+    prepareToPlay and the memory it holds afterwards. */
+class StartupBenchmark : public Benchmark
+{
+public:
+    StartupBenchmark() : Benchmark("Startup") {}
+
+    void runTest() override
+    {
+        // one already loaded, the way a session is after its first instance, so
+        // the default tables are cache hits from here on
+        BitmaskerEngine first;
+
+        beginTest("constructor");
+        {
+            std::vector<std::unique_ptr<BitmaskerEngine>> engines;
+            engines.reserve(numInstances);
+
+            const double us = bittytest::bestMicroseconds(rounds, [&engines]
+            {
+                engines.clear();
+                for (int i = 0; i < numInstances; ++i) engines.push_back(std::make_unique<BitmaskerEngine>());
+            }) / numInstances;
+
+            logMessage("constructor: " + String(us, 2) + " us per instance");
+            expectTimeWithin(us, constructorBudgetMicroseconds, "constructor");
+        }
+
+        beginTest("prepareToPlay");
+        {
+            // the first prepare of a fresh instance is the one a session load pays for
+            double us = std::numeric_limits<double>::max();
+
+            for (int round = 0; round < rounds; ++round)
+            {
+                std::vector<std::unique_ptr<BitmaskerEngine>> engines;
+                for (int i = 0; i < numInstances; ++i) engines.push_back(std::make_unique<BitmaskerEngine>());
+
+                us = jmin(us, bittytest::bestMicroseconds(1, [&engines]
+                {
+                    for (auto& e : engines) bittytest::prepare(*e);
+                }) / numInstances);
+            }
+
+            logMessage("prepareToPlay: " + String(us, 2) + " us per instance, stereo, 512 samples");
+            expectTimeWithin(us, prepareBudgetMicroseconds, "prepareToPlay");
+        }
+
+        beginTest("bytes per instance");
+        {
+            std::unique_ptr<BitmaskerEngine> e;
+            size_t constructed, prepared;
+
+            {
+                bittytest::ScopedAllocationCounter counter;
+                e = std::make_unique<BitmaskerEngine>();
+                constructed = counter.getBytes();
+            }
+
+            {
+                bittytest::ScopedAllocationCounter counter;
+                bittytest::prepare(*e);
+                prepared = counter.getBytes();
+            }
+
+            // the heap figure includes the object itself, which make_unique allocated
+            const size_t total = constructed + prepared;
+            logMessage("bytes per instance: " + String(static_cast<int64>(sizeof(BitmaskerEngine))) + " object, "
+                       + String(static_cast<int64>(constructed)) + " after construction, "
+                       + String(static_cast<int64>(total)) + " after prepareToPlay");
+
+            expectLessOrEqual(constructed, constructedBudgetBytes, "bytes after construction");
+            expectLessOrEqual(total, preparedBudgetBytes, "bytes after prepareToPlay");
+        }
+    }
+
+private:
+    static constexpr int numInstances = 100, rounds = 5;
+
+    // about ten times what an optimised build takes today. the memory is mostly the
+    // stereo working buffers; eager per-channel filters would blow the first budget
+    static constexpr double constructorBudgetMicroseconds = 25;
+    static constexpr double prepareBudgetMicroseconds = 50;
+    static constexpr size_t constructedBudgetBytes = 12 * 1024;
+    static constexpr size_t preparedBudgetBytes = 64 * 1024;
+};
+
+static StartupBenchmark startupBenchmark;
+
+//==============================================================================
+/** float mode edits the host's float words where they are, so its kernel shouldn't
+    cost more than the 16 bit mode's round trip: converting to integers, the table,
+    and converting back. the rest of the engine is the same either way, so it's
+    left out of the timing. */
+class FloatModeBenchmark : public Benchmark
+{
+public:
+    FloatModeBenchmark() : Benchmark("Float mode") {}
+
+    void runTest() override
+    {
+        // ratios of the two, so they hold on any machine. the masks are a pass over
+        // the words either way, and a pair of swapped bits is a byte lookup against
+        // a word lookup; a release build is about 0.2x and 0.45x today
+        beginTest("masks against 16 bit");
+        compare(false, 0.5);
+
+        beginTest("remap against 16 bit");
+        compare(true, 0.75);
+    }
+
+private:
+    static constexpr int blocksPerRound = 200;
+
+    void compare(bool remapped, double budget)
+    {
+        const int n = bittytest::maxBlockSize;
+        const AudioBuffer<float> signal = bittytest::makeSignal(n);
+        AudioBuffer<float> buffer(signal);
+        std::vector<std::vector<BitWord>> words(static_cast<size_t>(signal.getNumChannels()), std::vector<BitWord>(static_cast<size_t>(n)));
+
+        std::array<uint8, N_BITS> remap;
+        for (int i = 0; i < N_BITS; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+        std::array<uint8, 32> floatRemap;
+        for (int i = 0; i < 32; ++i) floatRemap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+
+        if (remapped)
+        {
+            std::swap(remap[4], remap[8]);
+            std::swap(floatRemap[20], floatRemap[22]);
+        }
+
+        const auto table = TransformTable::build(BitExpression(), remap, std::bitset<N_BITS>(0xfff0), {}, std::bitset<N_BITS>(0x0005));
+        const auto floatTable = FloatBitTable::build(floatRemap, std::bitset<32>(0xfffff000), {}, std::bitset<32>(0x00000005));
+        expect(table->masksOnly != remapped);
+        expect(floatTable->identityRemap != remapped);
+
+        double integerUs = std::numeric_limits<double>::max(), floatUs = integerUs;
+
+        for (int round = 0; round < 9; ++round)
+        {
+            buffer.makeCopyOf(signal, true);
+            integerUs = jmin(integerUs, bittytest::bestMicroseconds(1, [&]
+            {
+                for (int block = 0; block < blocksPerRound; ++block)
+                {
+                    for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                    {
+                        BitWord* w = words[static_cast<size_t>(chan)].data();
+                        toWords(buffer.getReadPointer(chan), w, n);
+                        table->process(w, n);
+                        fromWords(w, buffer.getWritePointer(chan), n);
+                    }
+                }
+            }));
+
+            buffer.makeCopyOf(signal, true);
+            floatUs = jmin(floatUs, bittytest::bestMicroseconds(1, [&]
+            {
+                for (int block = 0; block < blocksPerRound; ++block)
+                    for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                        floatTable->process(buffer.getWritePointer(chan), n);
+            }));
+        }
+
+        const double perSample = 1000.0 / (static_cast<double>(blocksPerRound) * n * buffer.getNumChannels());
+        logMessage("16 bit: " + String(integerUs * perSample, 3) + " ns per sample, float: " + String(floatUs * perSample, 3)
+                   + " ns per sample (" + String(floatUs / integerUs, 2) + "x)");
+        expectTimeWithin(floatUs / integerUs, budget, "float mode against 16 bit");
+    }
+
+    // the same conversions BitmaskerEngine makes around the table
+   #if N_BITS == 8
+    using IntFormat = AudioData::Int8;
+   #elif N_BITS == 16
+    using IntFormat = AudioData::Int16;
+   #endif
+
+    static void toWords(const float* src, BitWord* dst, int n)
+    {
+        AudioData::Pointer<IntFormat, AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::NonConst> d(dst);
+        d.convertSamples(AudioData::Pointer<AudioData::Float32, AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::Const>(src), n);
+    }
+
+    static void fromWords(const BitWord* src, float* dst, int n)
+    {
+        AudioData::Pointer<AudioData::Float32, AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::NonConst> d(dst);
+        d.convertSamples(AudioData::Pointer<IntFormat, AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::Const>(src), n);
+    }
+};
+
+static FloatModeBenchmark floatModeBenchmark;
+
+//==============================================================================
+/** three bands pay for the crossover bank and two more trips through integers and
+    the tables on top of what one band costs. */
+class MultibandBenchmark : public Benchmark
+{
+public:
+    MultibandBenchmark() : Benchmark("Multiband") {}
+
+    void runTest() override
+    {
+        beginTest("three bands against one");
+
+        BitmaskerEngine single, three;
+        for (BitmaskerEngine* e : { &single, &three }) bittytest::prepare(*e);
+
+        three.setNumBands(3);
+        three.setCrossover(0, 300.0f);
+        three.setCrossover(1, 3000.0f);
+
+        for (int band = 0; band < 3; ++band)
+        {
+            for (BitmaskerEngine* e : { &single, &three })
+            {
+                e->setandmask("1111111111110000", band);
+                e->setxormask("0000000000000101", band);
+            }
+        }
+
+        const auto ns = nanosecondsPerSample({ &single, &three });
+
+        logMessage("1 band: " + String(ns[0], 2) + " ns per sample, 3 bands: " + String(ns[1], 2)
+                   + " ns per sample (" + String(ns[1] / ns[0], 2) + "x)");
+        expectTimeWithin(ns[1] / ns[0], threeBandBudget, "3 bands against 1");
+    }
+
+private:
+    // a release build is about 1.4x today. a stereo pair fills half the lanes, so
+    // the crossover bank runs independent sections in the other half and takes
+    // four filter steps per sample rather than seven
+    static constexpr double threeBandBudget = 1.5;
+};
+
+static MultibandBenchmark multibandBenchmark;
+
+//==============================================================================
+/** the cross-channel kernel against the per-channel masks it sits next to, on the
+    same words: moving bit planes between channels shouldn't cost much more than
+    masking them where they are. */
+class ChannelMixerBenchmark : public Benchmark
+{
+public:
+    ChannelMixerBenchmark() : Benchmark("Channel mixer") {}
+
+    void runTest() override
+    {
+        // ratios of the two, so they hold on any machine. a stereo pair is one pass
+        // like the masks, about 1x today. interleaving four bits over a quad bus is
+        // one pass too, but every output takes bits from all four channels: sixteen
+        // masked words per sample where the masks have one, about 3x
+        beginTest("stereo rotate");
+        compare(2, ChannelBitMixer::Mode::rotate, 2.0);
+
+        beginTest("quad interleave");
+        compare(4, ChannelBitMixer::Mode::interleave, 4.0);
+    }
+
+private:
+    static constexpr int blocksPerRound = 200;
+
+    void compare(int numChannels, ChannelBitMixer::Mode mode, double budget)
+    {
+        const int n = bittytest::maxBlockSize;
+        std::vector<std::vector<BitWord>> words(static_cast<size_t>(numChannels), std::vector<BitWord>(static_cast<size_t>(n)));
+        std::vector<BitWord*> pointers;
+
+        Random r(1);
+        for (auto& w : words)
+        {
+            for (auto& x : w) x = static_cast<BitWord>(r.nextInt(1 << N_BITS));
+            pointers.push_back(w.data());
+        }
+
+        std::array<uint8, N_BITS> remap;
+        for (int i = 0; i < N_BITS; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+        const auto table = TransformTable::build(BitExpression(), remap, std::bitset<N_BITS>(0xfff0), {}, std::bitset<N_BITS>(0x0005));
+        expect(table->masksOnly);
+
+        ChannelBitMixer mixer;
+        mixer.prepare(numChannels, n);
+        const std::bitset<N_BITS> bits(0x0f00);
+
+        double maskUs = std::numeric_limits<double>::max(), mixUs = maskUs;
+
+        for (int round = 0; round < 9; ++round)
+        {
+            maskUs = jmin(maskUs, bittytest::bestMicroseconds(1, [&]
+            {
+                for (int block = 0; block < blocksPerRound; ++block)
+                    for (BitWord* p : pointers) table->process(p, n);
+            }));
+
+            mixUs = jmin(mixUs, bittytest::bestMicroseconds(1, [&]
+            {
+                for (int block = 0; block < blocksPerRound; ++block)
+                    mixer.process(pointers.data(), numChannels, n, mode, bits, 1);
+            }));
+        }
+
+        const double perSample = 1000.0 / (static_cast<double>(blocksPerRound) * n * numChannels);
+        logMessage("masks: " + String(maskUs * perSample, 3) + " ns per sample, mixer: " + String(mixUs * perSample, 3)
+                   + " ns per sample (" + String(mixUs / maskUs, 2) + "x)");
+        expectTimeWithin(mixUs / maskUs, budget, "channel mixer against masks");
+    }
+};
+
+static ChannelMixerBenchmark channelMixerBenchmark;
+
+//==============================================================================
+/** flip noise on every bit against the per-channel masks on the same words. rare
+    flips are paid for per flip and common ones per sample, so the rates cover both
+    sides of BitNoise::denseAbove. */
+class NoiseBenchmark : public Benchmark
+{
+public:
+    NoiseBenchmark() : Benchmark("Bit noise") {}
+
+    void runTest() override
+    {
+        // ratios of the two, so they hold on any machine. a mask is a single and, or
+        // and xor, and this is sixteen random draws per sample; a release build is
+        // about 13x, 60x and 80x today, where stepping by gaps alone was 700x at 10%
+        beginTest("0.1% against masks");
+        compare(0.001f, 20.0);
+
+        beginTest("1% against masks");
+        compare(0.01f, 100.0);
+
+        beginTest("10% against masks");
+        compare(0.1f, 120.0);
+    }
+
+private:
+    static constexpr int numChannels = 2, blocksPerRound = 200;
+
+    void compare(float probability, double budget)
+    {
+        const int n = bittytest::maxBlockSize;
+        std::vector<std::vector<BitWord>> words(static_cast<size_t>(numChannels), std::vector<BitWord>(static_cast<size_t>(n)));
+
+        Random r(1);
+        for (auto& w : words)
+            for (auto& x : w) x = static_cast<BitWord>(r.nextInt(1 << N_BITS));
+
+        std::array<uint8, N_BITS> remap;
+        for (int i = 0; i < N_BITS; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+        const auto table = TransformTable::build(BitExpression(), remap, std::bitset<N_BITS>(0xfff0), {}, std::bitset<N_BITS>(0x0005));
+        expect(table->masksOnly);
+
+        BitNoise noise;
+        noise.prepare(numChannels);
+        std::array<float, N_BITS> probabilities;
+        probabilities.fill(probability);
+        noise.setProbabilities(probabilities);
+
+        double maskUs = std::numeric_limits<double>::max(), noiseUs = maskUs;
+        int64 position = 0;
+
+        for (int round = 0; round < 9; ++round)
+        {
+            maskUs = jmin(maskUs, bittytest::bestMicroseconds(1, [&]
+            {
+                for (int block = 0; block < blocksPerRound; ++block)
+                    for (auto& w : words) table->process(w.data(), n);
+            }));
+
+            noiseUs = jmin(noiseUs, bittytest::bestMicroseconds(1, [&]
+            {
+                for (int block = 0; block < blocksPerRound; ++block, position += n)
+                    for (int chan = 0; chan < numChannels; ++chan)
+                        noise.process(chan, words[static_cast<size_t>(chan)].data(), n, position, 1);
+            }));
+        }
+
+        const double perSample = 1000.0 / (static_cast<double>(blocksPerRound) * n * numChannels);
+        logMessage("masks: " + String(maskUs * perSample, 3) + " ns per sample, noise: " + String(noiseUs * perSample, 3)
+                   + " ns per sample (" + String(noiseUs / maskUs, 2) + "x)");
+        expectTimeWithin(noiseUs / maskUs, budget, "bit noise against masks");
+    }
+};
+
+static NoiseBenchmark noiseBenchmark;
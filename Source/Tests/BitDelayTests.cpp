@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    BitDelayTests.cpp
+    Created: 19 Oct 2026 11:59:04pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "TestHelpers.h"
+
+
+/** the chunked ring buffer against the recurrence written out one sample at a time,
+    over random ragged blocks, with delays shorter than a block, of one sample, and
+    long enough to wrap the ring. */
+class BitDelayTests : public UnitTest
+{
+public:
+    BitDelayTests() : UnitTest("BitDelay", "bitty") {}
+
+    void runTest() override
+    {
+        Random r = getRandom();
+
+        for (bool feedback : { false, true })
+        {
+            beginTest(feedback ? "feedback against x[n] op y[n-D]" : "input against x[n] op x[n-D]");
+
+            for (BitDelay::Op op : { BitDelay::Op::xorOp, BitDelay::Op::andOp, BitDelay::Op::orOp })
+                for (int delay : { 1, 2, 7, maxBlockSize - 1, maxBlockSize, maxBlockSize + 1, 300, 1900 })
+                    for (bool lut : { false, true })
+                        check(r, op, feedback, delay, lut);
+        }
+    }
+
+private:
+    static constexpr int maxBlockSize = 64, numChannels = 2, numSamples = 6000;
+
+    // a short maximum delay, so the ring is small and wraps over and over
+    static constexpr double sampleRate = 1000;
+
+    void check(Random& r, BitDelay::Op op, bool feedback, int delay, bool lut)
+    {
+        std::array<uint8, N_BITS> remap;
+        for (int i = 0; i < N_BITS; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+        if (lut) std::swap(remap[1], remap[9]);
+
+        auto randomMask = [&r] { return std::bitset<N_BITS>(static_cast<unsigned long long>(r.nextInt(1 << N_BITS))); };
+        const auto table = TransformTable::build(BitExpression(), remap, randomMask() | std::bitset<N_BITS>(0xff00), {}, randomMask());
+
+        std::vector<std::vector<BitWord>> input(static_cast<size_t>(numChannels), std::vector<BitWord>(static_cast<size_t>(numSamples)));
+        for (auto& chan : input)
+            for (auto& x : chan) x = static_cast<BitWord>(r.nextInt(1 << N_BITS));
+
+        BitDelay d;
+        d.prepare(numChannels, maxBlockSize, sampleRate);
+        expectLessOrEqual(delay, d.getMaxDelay());
+
+        // blocks up to twice what prepare() was told, which process() has to split itself
+        auto output = input;
+        for (int start = 0; start < numSamples;)
+        {
+            const int n = jmin(1 + r.nextInt(2 * maxBlockSize), numSamples - start);
+            for (int chan = 0; chan < numChannels; ++chan)
+                d.process(chan, output[static_cast<size_t>(chan)].data() + start, n, delay, op, feedback, *table);
+            d.advance(n);
+            start += n;
+        }
+
+        int wrong = 0;
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            const auto want = reference(input[static_cast<size_t>(chan)], delay, op, feedback, *table);
+            for (int i = 0; i < numSamples; ++i)
+                wrong += output[static_cast<size_t>(chan)][static_cast<size_t>(i)] != want[static_cast<size_t>(i)];
+        }
+
+        expectEquals(wrong, 0, String(feedback ? "feedback" : "input") + ", op " + String(static_cast<int>(op))
+                                   + ", delay " + String(delay) + (lut ? ", lut" : ", masks"));
+    }
+
+    /** the ring starts out silent, so anything from before the first sample is 0. */
+    static std::vector<BitWord> reference(const std::vector<BitWord>& x, int delay, BitDelay::Op op, bool feedback, const TransformTable& table)
+    {
+        std::vector<BitWord> y(x.size());
+
+        for (size_t n = 0; n < x.size(); ++n)
+        {
+            const BitWord past = n < static_cast<size_t>(delay) ? BitWord(0) : (feedback ? y : x)[n - static_cast<size_t>(delay)];
+            BitWord v = x[n];
+
+            switch (op)
+            {
+                case BitDelay::Op::xorOp: v = static_cast<BitWord>(v ^ past); break;
+                case BitDelay::Op::andOp: v = static_cast<BitWord>(v & past); break;
+                case BitDelay::Op::orOp:  v = static_cast<BitWord>(v | past); break;
+                case BitDelay::Op::off:   break;
+            }
+
+            y[n] = table.lut[v];
+        }
+
+        return y;
+    }
+};
+
+static BitDelayTests bitDelayTests;
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    ChannelBitMixerTests.cpp
+    Created: 19 Oct 2026 11:59:21pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "TestHelpers.h"
+
+
+/** every layout's kernel (the stereo pair, the per-chunk frames and the scratch path
+    past ChannelBitMixer::maxFrameChannels) against each bit picked from its source
+    the slow way, written from the mode descriptions rather than from the matrix. */
+class ChannelBitMixerTests : public UnitTest
+{
+public:
+    ChannelBitMixerTests() : UnitTest("ChannelBitMixer", "bitty") {}
+
+    void runTest() override
+    {
+        Random r = getRandom();
+
+        for (int numChannels : { 2, 3, 4, 5, 6, ChannelBitMixer::maxFrameChannels + 1, ChannelBitMixer::maxFrameChannels + 2 })
+        {
+            beginTest(String(numChannels) + " channels");
+
+            for (auto mode : { ChannelBitMixer::Mode::rotate, ChannelBitMixer::Mode::copy, ChannelBitMixer::Mode::interleave })
+                for (int trial = 0; trial < 20; ++trial)
+                    check(r, numChannels, mode);
+        }
+
+        beginTest("off and no bits leave the words alone");
+        {
+            std::vector<std::vector<BitWord>> words;
+            auto pointers = makeWords(r, 4, maxBlockSize, words);
+            const auto before = words;
+
+            ChannelBitMixer mixer;
+            mixer.prepare(4, maxBlockSize);
+            mixer.process(pointers.data(), 4, maxBlockSize, ChannelBitMixer::Mode::off, std::bitset<N_BITS>(0xffff), 1);
+            mixer.process(pointers.data(), 4, maxBlockSize, ChannelBitMixer::Mode::rotate, {}, 1);
+            expect(words == before);
+        }
+    }
+
+private:
+    static constexpr int maxBlockSize = 128;
+
+    void check(Random& r, int numChannels, ChannelBitMixer::Mode mode)
+    {
+        // blocks past what prepare() was told too, which the scratch path has to take in pieces
+        const int n = 1 + r.nextInt(3 * maxBlockSize);
+        const int offset = r.nextInt(4 * numChannels + 1) - 2 * numChannels;
+        const auto bits = static_cast<uint32>(r.nextInt(1 << N_BITS));
+
+        std::vector<std::vector<BitWord>> words;
+        auto pointers = makeWords(r, numChannels, n, words);
+        const auto input = words;
+
+        ChannelBitMixer mixer;
+        mixer.prepare(numChannels, maxBlockSize);
+        mixer.process(pointers.data(), numChannels, n, mode, std::bitset<N_BITS>(bits), offset);
+
+        auto wrap = [numChannels] (int c) { return ((c % numChannels) + numChannels) % numChannels; };
+
+        int wrong = 0;
+        for (int out = 0; out < numChannels; ++out)
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                uint32 want = 0;
+                for (int b = 0; b < N_BITS; ++b)
+                {
+                    int src = out;
+                    if ((bits >> b) & 1)
+                    {
+                        switch (mode)
+                        {
+                            case ChannelBitMixer::Mode::rotate:     src = wrap(out + offset); break;
+                            case ChannelBitMixer::Mode::copy:       src = wrap(offset); break;
+                            case ChannelBitMixer::Mode::interleave: src = wrap(out + b + offset); break;
+                            case ChannelBitMixer::Mode::off:        break;
+                        }
+                    }
+
+                    want |= input[static_cast<size_t>(src)][static_cast<size_t>(i)] & (1u << b);
+                }
+
+                wrong += words[static_cast<size_t>(out)][static_cast<size_t>(i)] != static_cast<BitWord>(want);
+            }
+        }
+
+        expectEquals(wrong, 0, "mode " + String(static_cast<int>(mode)) + ", offset " + String(offset)
+                                   + ", bits " + String::toHexString(static_cast<int>(bits)) + ", " + String(n) + " samples");
+    }
+
+    static std::vector<BitWord*> makeWords(Random& r, int numChannels, int n, std::vector<std::vector<BitWord>>& words)
+    {
+        words.assign(static_cast<size_t>(numChannels), std::vector<BitWord>(static_cast<size_t>(n)));
+
+        std::vector<BitWord*> pointers;
+        for (auto& w : words)
+        {
+            for (auto& x : w) x = static_cast<BitWord>(r.nextInt(1 << N_BITS));
+            pointers.push_back(w.data());
+        }
+
+        return pointers;
+    }
+};
+
+static ChannelBitMixerTests channelBitMixerTests;
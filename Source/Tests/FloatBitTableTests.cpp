@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    FloatBitTableTests.cpp
+    Created: 19 Oct 2026 11:59:37pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <bitset>
+#include <cmath>
+#include <cstring>
+
+#include "TestHelpers.h"
+
+
+/** the float kernels, masks only and remapped, against the words worked out a bit at
+    a time from FloatBitTable's description, over random words and the special values,
+    with settings that push words into inf and nan for the guard to catch. */
+class FloatBitTableTests : public UnitTest
+{
+public:
+    FloatBitTableTests() : UnitTest("FloatBitTable", "bitty") {}
+
+    void runTest() override
+    {
+        Random r = getRandom();
+        const std::vector<uint32> words = makeWords(r);
+
+        for (int config = 0; config < 16; ++config)
+        {
+            std::array<uint8, 32> remap;
+            std::bitset<32> andmask, ormask, xormask;
+            makeConfig(config, r, remap, andmask, ormask, xormask);
+
+            const auto table = FloatBitTable::build(remap, andmask, ormask, xormask);
+            beginTest("config " + String(config) + (table->identityRemap ? ", masks" : ", remapped"));
+
+            std::vector<float> samples(words.size());
+            std::memcpy(samples.data(), words.data(), words.size() * sizeof(uint32));
+            table->process(samples.data(), static_cast<int>(samples.size()));
+
+            int wrong = 0, notFinite = 0;
+            for (size_t i = 0; i < words.size(); ++i)
+            {
+                uint32 got;
+                std::memcpy(&got, &samples[i], sizeof(got));
+                wrong += got != reference(words[i], remap, andmask, ormask, xormask);
+                notFinite += std::isfinite(samples[i]) ? 0 : 1;
+            }
+
+            expectEquals(wrong, 0);
+            expectEquals(notFinite, 0, "inf or nan got through");
+        }
+    }
+
+private:
+    /** bits moved to the same place OR together, one past the top drops its bit, and an
+        all ones exponent leaves only the sign. */
+    static uint32 reference(uint32 word, const std::array<uint8, 32>& remap,
+                            std::bitset<32> andmask, std::bitset<32> ormask, std::bitset<32> xormask)
+    {
+        const std::bitset<32> in(word);
+        std::bitset<32> out;
+
+        for (size_t idx = 0; idx < 32; ++idx)
+            if (remap[idx] < 32 && in[idx])
+                out[remap[idx]] = true;
+
+        const auto u = static_cast<uint32>((((out & andmask) | ormask) ^ xormask).to_ulong());
+        return (u & FloatBitTable::exponentBits) == FloatBitTable::exponentBits ? (u & FloatBitTable::signBits) : u;
+    }
+
+    /** random words, with the special values and some near them thrown in. */
+    static std::vector<uint32> makeWords(Random& r)
+    {
+        std::vector<uint32> words { 0x00000000u, 0x80000000u, 0x7f800000u, 0xff800000u, 0x7fc00000u, 0xffffffffu,
+                                    0x00000001u, 0x007fffffu, 0x7f7fffffu, 0x3f800000u, 0xbf800000u };
+
+        for (int i = 0; i < 4096; ++i)
+        {
+            auto w = static_cast<uint32>(r.nextInt64());
+            if (i % 8 == 0) w |= FloatBitTable::exponentBits;
+            words.push_back(w);
+        }
+
+        return words;
+    }
+
+    /** a few hand-picked settings, then random ones including remaps with collisions and dropped bits. */
+    static void makeConfig(int config, Random& r, std::array<uint8, 32>& remap,
+                           std::bitset<32>& andmask, std::bitset<32>& ormask, std::bitset<32>& xormask)
+    {
+        for (int i = 0; i < 32; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+        andmask.set();
+        ormask.reset();
+        xormask.reset();
+
+        auto randomMask = [&r] { return std::bitset<32>(static_cast<unsigned long long>(static_cast<uint32>(r.nextInt64()))); };
+
+        switch (config)
+        {
+            case 0: break;
+            case 1: andmask = randomMask(); ormask = randomMask(); xormask = randomMask(); break;
+            case 2: ormask = std::bitset<32>(FloatBitTable::exponentBits); break;
+            case 3: xormask = std::bitset<32>(0x40000000u); break;
+            case 4: std::swap(remap[20], remap[22]); break;
+            case 5: std::swap(remap[0], remap[31]); break;
+            case 6: for (int i = 0; i < 32; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(31 - i); break;
+            case 7: std::fill(remap.begin(), remap.end(), static_cast<uint8>(26)); break;
+            case 8: remap[3] = 32; remap[30] = 3; break;
+            default:
+                for (auto& v : remap) v = static_cast<uint8>(r.nextInt(33));
+                andmask = randomMask();
+                ormask = randomMask();
+                xormask = randomMask();
+                break;
+        }
+    }
+};
+
+static FloatBitTableTests floatBitTableTests;
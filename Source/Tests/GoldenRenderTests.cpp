@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+    GoldenRenderTests.cpp
+    Created: 19 Oct 2026 11:06:25pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <functional>
+
+#include "TestHelpers.h"
+
+
+/** renders the test signal through each mode and compares with Tests/golden/<mode>.wav.
+    each mode is rendered twice, in even and ragged blocks, and the two have to match
+    exactly before either is compared. bitty_tests --write-golden rewrites the files
+    after a deliberate change to the sound. */
+class GoldenRenderTests : public UnitTest
+{
+public:
+    GoldenRenderTests() : UnitTest("Golden renders", "bitty") {}
+
+    void runTest() override
+    {
+        beginTest("integer");
+        check("integer", [] (BitmaskerEngine& e)
+        {
+            e.setandmask("1111111111110000");
+            e.setxormask("0000000100010101");
+            e.setEntireBitRemap({ 0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7, 12, 13, 14, 15 });
+            e.setExpression("x < 0 ? ~x : rotl(x, 1)");
+        });
+
+        beginTest("float");
+        check("float", [] (BitmaskerEngine& e)
+        {
+            std::array<uint8, 32> remap;
+            for (int i = 0; i < 32; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+            std::swap(remap[20], remap[22]);
+
+            e.setFloatMode(true);
+            e.setfloatandmask("11111111111111111111000000000000");
+            e.setfloatxormask("00000000000000000100000000000000");
+            e.setEntireFloatBitRemap(remap);
+        });
+
+        beginTest("delay");
+        check("delay", [] (BitmaskerEngine& e)
+        {
+            e.setxormask("0000000000000011");
+            e.setDelayOp(BitDelay::Op::xorOp);
+            e.setDelayFeedback(true);
+            e.setDelaySeconds(0.005);
+        });
+
+        beginTest("channel mixer");
+        check("mixer", [] (BitmaskerEngine& e)
+        {
+            e.setCrossMode(ChannelBitMixer::Mode::interleave);
+            e.setCrossMask("0000111100000000");
+            e.setCrossOffset(1);
+        });
+
+        beginTest("multiband");
+        check("multiband", [] (BitmaskerEngine& e)
+        {
+            e.setNumBands(3);
+            e.setCrossover(0, 300.0f);
+            e.setCrossover(1, 3000.0f);
+            e.setandmask("1111111100000000", 0);
+            e.setxormask("0000000000110000", 1);
+            e.setEntireBitRemap({ 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }, 2);
+        });
+
+        beginTest("midi");
+        {
+            MidiBuffer midi;
+            midi.addEvent(MidiMessage::noteOn(1, BitmaskerEngine::midiLowestNote + 15, 1.0f), 100);
+            midi.addEvent(MidiMessage::noteOn(2, BitmaskerEngine::midiLowestNote + 14, 1.0f), 300);
+            midi.addEvent(MidiMessage::noteOff(1, BitmaskerEngine::midiLowestNote + 15), 700);
+            midi.addEvent(MidiMessage::noteOn(3, BitmaskerEngine::midiLowestNote + 2, 1.0f), 900);
+            midi.addEvent(MidiMessage::programChange(1, 3), 1100);
+            midi.addEvent(MidiMessage::noteOff(2, BitmaskerEngine::midiLowestNote + 14), 1300);
+            midi.addEvent(MidiMessage::programChange(1, 6), 1500);
+            midi.addEvent(MidiMessage::allNotesOff(1), 1700);
+            midi.addEvent(MidiMessage::programChange(1, 0), 1900);
+
+            check("midi", [] (BitmaskerEngine& e)
+            {
+                e.setProgramChangeRemaps(true);
+                e.setxormask("0000000000000001");
+            }, midi);
+        }
+
+        beginTest("bit noise");
+        check("noise", [] (BitmaskerEngine& e)
+        {
+            for (int bit = 0; bit < 4; ++bit) e.setFlipProbability(bit, 0.05f);
+            e.setFlipProbability(8, 0.01f);
+            e.setFlipProbability(14, 0.002f);
+            e.setNoiseSeed(1234);
+        });
+    }
+
+private:
+    static constexpr int numSamples = 2048;
+
+    // well under one 16 bit step, so a sample the quantiser rounds the other way fails
+    static constexpr float tolerance = 1.0e-5f;
+
+    void check(const String& mode, const std::function<void(BitmaskerEngine&)>& setup, const MidiBuffer& midi = MidiBuffer())
+    {
+        const AudioBuffer<float> input = bittytest::makeSignal(numSamples);
+        AudioBuffer<float> even(input), ragged(input);
+
+        BitmaskerEngine a, b;
+        for (BitmaskerEngine* e : { &a, &b })
+        {
+            bittytest::prepare(*e);
+            setup(*e);
+        }
+
+        expectEquals(bittytest::render(a, even, { 256 }, midi), 0, mode + " allocated on the audio thread");
+        expectEquals(bittytest::render(b, ragged, { 1, 67, bittytest::maxBlockSize, 130, 3 }, midi), 0, mode + " allocated on the audio thread");
+        expectEquals(bittytest::firstDifference(even, ragged), -1, mode + " depends on the block size");
+
+        const File file = bittytest::goldenDirectory().getChildFile(mode + ".wav");
+
+        if (bittytest::shouldWriteGolden())
+        {
+            expect(bittytest::writeWav(file, even), "couldn't write " + file.getFullPathName());
+            logMessage("wrote " + file.getFullPathName());
+            return;
+        }
+
+        AudioBuffer<float> golden;
+        if (! readWav(file, golden))
+        {
+            expect(false, "couldn't read " + file.getFullPathName() + " (bitty_tests --write-golden makes it)");
+            return;
+        }
+
+        expectEquals(golden.getNumChannels(), even.getNumChannels(), mode + " channels");
+        expectEquals(golden.getNumSamples(), even.getNumSamples(), mode + " length");
+        if (golden.getNumChannels() != even.getNumChannels() || golden.getNumSamples() != even.getNumSamples()) return;
+
+        int outliers = 0;
+        float worst = 0;
+        for (int chan = 0; chan < even.getNumChannels(); ++chan)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float diff = std::abs(even.getSample(chan, i) - golden.getSample(chan, i));
+                outliers += diff > tolerance;
+                worst = jmax(worst, diff);
+            }
+        }
+
+        expectEquals(outliers, 0, mode + ": samples off the golden render, worst by " + String(worst));
+    }
+
+    static bool readWav(const File& file, AudioBuffer<float>& buffer)
+    {
+        if (! file.existsAsFile()) return false;
+
+        std::unique_ptr<AudioFormatReader> reader(WavAudioFormat().createReaderFor(new FileInputStream(file), true));
+        if (reader == nullptr) return false;
+
+        buffer.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    }
+};
+
+static GoldenRenderTests goldenRenderTests;
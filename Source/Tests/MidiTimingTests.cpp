@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    MidiTimingTests.cpp
+    Created: 19 Oct 2026 11:41:33pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "TestHelpers.h"
+
+
+/** midi has to act on its own sample: the same signal rendered with and without an
+    event first differs exactly at the event, wherever it falls in the block. */
+class MidiTimingTests : public UnitTest
+{
+public:
+    MidiTimingTests() : UnitTest("MIDI timing", "bitty") {}
+
+    void runTest() override
+    {
+        const int flipNote = BitmaskerEngine::midiLowestNote + 12;
+
+        for (bool delay : { false, true })
+        {
+            const String suffix = delay ? ", delay on" : "";
+
+            beginTest("note on" + suffix);
+            for (int offset : offsets)
+            {
+                MidiBuffer on;
+                on.addEvent(MidiMessage::noteOn(1, flipNote, 1.0f), offset);
+                expectFirstDifference(on, MidiBuffer(), offset, delay);
+            }
+
+            beginTest("note off" + suffix);
+            for (int offset : offsets)
+            {
+                MidiBuffer held, released;
+                held.addEvent(MidiMessage::noteOn(1, flipNote, 1.0f), 0);
+                released.addEvent(MidiMessage::noteOn(1, flipNote, 1.0f), 0);
+                released.addEvent(MidiMessage::noteOff(1, flipNote), offset);
+                expectFirstDifference(released, held, offset, delay);
+            }
+
+            beginTest("program change" + suffix);
+            for (int offset : offsets)
+            {
+                MidiBuffer change;
+                change.addEvent(MidiMessage::programChange(1, 1), offset);
+                expectFirstDifference(change, MidiBuffer(), offset, delay);
+            }
+        }
+
+        beginTest("program changes are ignored while switched off");
+        {
+            MidiBuffer change;
+            change.addEvent(MidiMessage::programChange(1, 1), 100);
+            expectEquals(firstDifference(change, MidiBuffer(), false, false), -1);
+        }
+    }
+
+private:
+    // either side of the 64 sample blocks these are rendered in, and the very first sample
+    static constexpr int offsets[] = { 0, 1, 63, 64, 65, 300, 511, 1000 };
+
+    void expectFirstDifference(const MidiBuffer& a, const MidiBuffer& b, int offset, bool delay)
+    {
+        expectEquals(firstDifference(a, b, delay, true), offset, "event at " + String(offset));
+    }
+
+    /** renders the test signal once with each buffer of midi, in 64 sample blocks. */
+    static int firstDifference(const MidiBuffer& a, const MidiBuffer& b, bool delay, bool programChanges)
+    {
+        AudioBuffer<float> withA = bittytest::makeSignal(1024), withB(withA);
+        BitmaskerEngine ea, eb;
+
+        for (BitmaskerEngine* e : { &ea, &eb })
+        {
+            bittytest::prepare(*e);
+            e->setProgramChangeRemaps(programChanges);
+            if (delay)
+            {
+                e->setDelayOp(BitDelay::Op::xorOp);
+                e->setDelayFeedback(true);
+                e->setDelaySeconds(0.001);
+            }
+        }
+
+        bittytest::render(ea, withA, { 64 }, a);
+        bittytest::render(eb, withB, { 64 }, b);
+        return bittytest::firstDifference(withA, withB);
+    }
+};
+
+static MidiTimingTests midiTimingTests;
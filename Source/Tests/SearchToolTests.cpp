@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    SearchToolTests.cpp
+    Created: 19 Oct 2026 11:59:59pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "TestHelpers.h"
+
+
+/** runs the bitty_search this tree built over a short wav of the test signal, a couple
+    of generations with a fixed seed, and loads every preset it writes into an engine
+    the way a session would be. its own category, so ctest can run it as a smoke test. */
+class SearchToolTests : public UnitTest
+{
+public:
+    SearchToolTests() : UnitTest("bitty_search", "search") {}
+
+    void runTest() override
+    {
+        const File dir = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("bitty_search_test", {}, false);
+        const File source = dir.getChildFile("source.wav");
+        const File first = dir.getChildFile("first"), second = dir.getChildFile("second");
+
+        beginTest("a seeded run writes its presets");
+        expect(bittytest::writeWav(source, bittytest::makeSignal(numSamples)), "couldn't write " + source.getFullPathName());
+        search(source, first);
+
+        beginTest("the presets load back into an engine");
+        for (int i = 1; i <= top; ++i)
+            checkPreset(preset(first, i));
+
+        beginTest("the same seed finds the same presets");
+        search(source, second);
+        for (int i = 1; i <= top; ++i)
+            expect(preset(first, i).loadFileAsString() == preset(second, i).loadFileAsString(), preset(second, i).getFileName() + " differs");
+
+        dir.deleteRecursively();
+    }
+
+private:
+    static constexpr int numSamples = 24000, top = 3;
+
+    static File preset(const File& dir, int i) { return dir.getChildFile("bitty_search_" + String(i) + ".xml"); }
+
+    void search(const File& source, const File& out)
+    {
+        const StringArray command { BITTY_SEARCH_PATH, source.getFullPathName(), "--reference", source.getFullPathName(),
+                                    "--generations", "2", "--seed", "1", "--population", "8", "--top", String(top),
+                                    "--out", out.getFullPathName() };
+
+        ChildProcess process;
+        if (! process.start(command))
+        {
+            expect(false, "couldn't start " + String(BITTY_SEARCH_PATH));
+            return;
+        }
+
+        const String output = process.readAllProcessOutput();
+        expect(process.waitForProcessToFinish(60000), "bitty_search didn't finish");
+        expectEquals(static_cast<int>(process.getExitCode()), 0, "bitty_search failed: " + output);
+    }
+
+    void checkPreset(const File& file)
+    {
+        std::unique_ptr<XmlElement> xml = parseXML(file);
+        expect(xml != nullptr, "couldn't parse " + file.getFullPathName());
+        if (xml == nullptr) return;
+
+        const ValueTree state = ValueTree::fromXml(*xml);
+        expect(state.isValid() && state.hasProperty("andmask"), file.getFileName() + " isn't a preset");
+
+        BitmaskerEngine e;
+        e.setState(state);
+        expect(e.getState().isEquivalentTo(state), file.getFileName() + " changed on the way into an engine");
+    }
+};
+
+static SearchToolTests searchToolTests;
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    StateFuzzTests.cpp
+    Created: 19 Oct 2026 11:19:02pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "TestHelpers.h"
+
+
+/** session blobs damaged every way a host or a disk might manage, loaded the same
+    way setStateInformation does. whatever comes in, the engine has to come out
+    playable: finite output, and no allocation on the audio thread. */
+class StateFuzzTests : public UnitTest
+{
+public:
+    StateFuzzTests() : UnitTest("State fuzzing", "bitty") {}
+
+    void runTest() override
+    {
+        const MemoryBlock good = makeBlob(busyState());
+        Random r = getRandom();
+
+        beginTest("the allocation counter counts");
+        {
+            static std::unique_ptr<int> kept; // escapes, so the allocation can't be optimised out
+            bittytest::ScopedAllocationCounter counter;
+            kept = std::make_unique<int>(1);
+            expectEquals(counter.getCount(), 1);
+        }
+
+        beginTest("a good blob round trips");
+        {
+            BitmaskerEngine e;
+            load(e, good.getData(), good.getSize());
+            expect(e.getState().isEquivalentTo(busyState()), "state changed on the way through a blob");
+        }
+
+        beginTest("damaged bytes");
+        for (int i = 0; i < 400; ++i)
+        {
+            MemoryBlock blob(good);
+            damageBytes(blob, r);
+            loadAndPlay(blob, r);
+        }
+
+        beginTest("junk values");
+        for (int i = 0; i < 400; ++i)
+        {
+            ValueTree vt = busyState();
+            for (int n = 1 + r.nextInt(6); n > 0; --n)
+            {
+                const Identifier key = vt.getPropertyName(r.nextInt(vt.getNumProperties()));
+                vt.setProperty(key, junkValue(r), nullptr);
+            }
+
+            loadAndPlay(makeBlob(vt), r);
+        }
+    }
+
+private:
+    /** every feature switched on, so every key has something in it. */
+    static ValueTree busyState()
+    {
+        BitmaskerEngine e;
+        e.setxormask("0000000000000101");
+        e.setExpression("rotl(x, 3) ^ gray(x)");
+        e.setNumBands(3);
+        e.setandmask("1111111100000000", 2);
+        e.setDelayOp(BitDelay::Op::andOp);
+        e.setCrossMode(ChannelBitMixer::Mode::rotate);
+        e.setFlipProbability(3, 0.1f);
+        e.setNoiseSeed(99);
+        e.setProgramChangeRemaps(true);
+        e.setfloatxormask("00000000000000000000000000000001");
+        return e.getState();
+    }
+
+    static MemoryBlock makeBlob(const ValueTree& vt)
+    {
+        MemoryBlock blob;
+        if (auto xml = vt.createXml()) AudioProcessor::copyXmlToBinary(*xml, blob);
+        return blob;
+    }
+
+    /** what bittyAudioProcessor::setStateInformation does. */
+    static void load(BitmaskerEngine& e, const void* data, size_t size)
+    {
+        std::unique_ptr<XmlElement> xml(AudioProcessor::getXmlFromBinary(data, static_cast<int>(size)));
+        if (xml == nullptr || ! xml->hasTagName("settings")) return;
+
+        e.setState(ValueTree::fromXml(*xml));
+    }
+
+    static void damageBytes(MemoryBlock& blob, Random& r)
+    {
+        auto* bytes = static_cast<uint8*>(blob.getData());
+        const int size = static_cast<int>(blob.getSize());
+
+        switch (r.nextInt(4))
+        {
+            case 0: // a few random bytes
+                for (int n = 1 + r.nextInt(8); n > 0; --n) bytes[r.nextInt(size)] = static_cast<uint8>(r.nextInt(256));
+                break;
+
+            case 1: // single bit flips, mostly leaving valid xml with odd values in it
+                for (int n = 1 + r.nextInt(4); n > 0; --n) bytes[r.nextInt(size)] ^= static_cast<uint8>(1 << r.nextInt(8));
+                break;
+
+            case 2: // cut short
+                blob.setSize(static_cast<size_t>(r.nextInt(size)));
+                break;
+
+            default: // a run of one value, like a zeroed sector
+            {
+                const int start = r.nextInt(size), length = jmin(size - start, 1 + r.nextInt(64));
+                std::fill(bytes + start, bytes + start + length, static_cast<uint8>(r.nextBool() ? 0 : r.nextInt(256)));
+                break;
+            }
+        }
+    }
+
+    static var junkValue(Random& r)
+    {
+        static const char* const junk[] = { "", "0", "1111", "2", "zz", "-1", "1e309", "nan", "inf", "-inf",
+                                            "99999999999", "0101010101010101010101", "((((", "x+", "\x01\x02",
+                                            "0123456789ABCDEF", "FFFFFFFFFFFFFFFF", "1 2 3 nan inf -5" };
+
+        switch (r.nextInt(4))
+        {
+            case 0: return String::repeatedString("(", 5000) + "x" + String::repeatedString(")", 5000);
+            case 1: return String::repeatedString("x+", 3000) + "x";
+            case 2: return r.nextDouble() * 1.0e12 - 5.0e11;
+            default: return junk[r.nextInt(numElementsInArray(junk))];
+        }
+    }
+
+    void loadAndPlay(const MemoryBlock& blob, Random& r)
+    {
+        BitmaskerEngine e;
+        bittytest::prepare(e);
+        load(e, blob.getData(), blob.getSize());
+
+        AudioBuffer<float> buffer = bittytest::makeSignal(1024);
+        int allocations = bittytest::render(e, buffer, { 1 + r.nextInt(bittytest::maxBlockSize) });
+
+        // and once more the other side of float mode
+        e.setFloatMode(! e.getFloatMode());
+        allocations += bittytest::render(e, buffer, { bittytest::maxBlockSize });
+
+        expectEquals(allocations, 0, "allocated on the audio thread");
+
+        int bad = 0;
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                bad += ! std::isfinite(buffer.getSample(chan, i));
+
+        expectEquals(bad, 0, "non-finite output");
+    }
+};
+
+static StateFuzzTests stateFuzzTests;
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    TableCacheTests.cpp
+    Created: 19 Oct 2026 11:59:58pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "TestHelpers.h"
+
+
+/** same settings share one table, the counts add up, and tables nobody holds any more
+    are freed by the reaper, on a cache of its own that looks every few milliseconds. */
+class TableCacheTests : public UnitTest
+{
+public:
+    TableCacheTests() : UnitTest("TableCache", "bitty") {}
+
+    void runTest() override
+    {
+        TableCache cache(reapIntervalMilliseconds);
+
+        std::array<uint8, N_BITS> remap;
+        for (int i = 0; i < N_BITS; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+
+        BitExpression expr;
+        expect(expr.parse("~x", N_BITS).wasOk());
+
+        beginTest("same settings share a table");
+        TableCache::Handle a = cache.acquire(expr, remap, std::bitset<N_BITS>(0xfff0), {}, std::bitset<N_BITS>(5));
+        TableCache::Handle b = cache.acquire(expr, remap, std::bitset<N_BITS>(0xfff0), {}, std::bitset<N_BITS>(5));
+        expect(a.get() != nullptr);
+        expect(a.get() == b.get());
+
+        beginTest("different settings don't");
+        TableCache::Handle c = cache.acquire(expr, remap, std::bitset<N_BITS>(0xfff0), {}, std::bitset<N_BITS>(6));
+        TableCache::Handle d = cache.acquire(BitExpression(), remap, std::bitset<N_BITS>(0xfff0), {}, std::bitset<N_BITS>(5));
+        expect(c.get() != a.get());
+        expect(d.get() != a.get() && d.get() != c.get());
+
+        beginTest("stats");
+        {
+            const auto s = cache.getStats();
+            expectEquals(s.numTables, 3);
+            expectEquals(s.numReferenced, 3);
+            expectEquals(s.numReferences, 4);
+            expectEquals(static_cast<int>(s.hits), 1);
+            expectEquals(static_cast<int>(s.misses), 3);
+        }
+
+        beginTest("a dropped handle is a reference less, not a table less");
+        {
+            b.reset();
+            const auto s = cache.getStats();
+            expectEquals(s.numTables, 3);
+            expectEquals(s.numReferenced, 3);
+            expectEquals(s.numReferences, 3);
+        }
+
+        beginTest("unreferenced tables are reaped, held ones aren't");
+        {
+            const TransformTable* held = a.get();
+            c.reset();
+            d.reset();
+
+            expect(waitForTables(cache, 1), "the reaper didn't free the unreferenced tables");
+            expect(a.get() == held);
+
+            // and a reaped table is built again, not found
+            TableCache::Handle again = cache.acquire(expr, remap, std::bitset<N_BITS>(0xfff0), {}, std::bitset<N_BITS>(6));
+            expect(again.get() != nullptr);
+            expectEquals(static_cast<int>(cache.getStats().misses), 4);
+        }
+    }
+
+private:
+    static constexpr int reapIntervalMilliseconds = 2;
+
+    /** true once the cache is down to numTables, giving up after a couple of seconds. */
+    static bool waitForTables(const TableCache& cache, int numTables)
+    {
+        for (int tries = 0; tries < 200; ++tries)
+        {
+            if (cache.getStats().numTables == numTables) return true;
+            Thread::sleep(10);
+        }
+
+        return false;
+    }
+};
+
+static TableCacheTests tableCacheTests;
@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    TestHelpers.h
+    Created: 19 Oct 2026 10:48:16pm
+    Author:  Zachary Lewis-Towbes
+
+    shared by the bitty_tests sources: the test signal, block-by-block
+    rendering, golden files, the allocation counter and benchmark timing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "../Engine.h"
+
+
+namespace bittytest
+{
+
+constexpr double sampleRate = 48000;
+constexpr int maxBlockSize = 512;
+
+/** counts operator new calls, and the bytes they asked for, made on this thread while it's alive.
+    the counting itself is the replacement operator new in TestMain.cpp. */
+class ScopedAllocationCounter
+{
+public:
+    ScopedAllocationCounter() noexcept : previous(current()) { current() = this; }
+    ~ScopedAllocationCounter() noexcept { current() = previous; }
+
+    int getCount() const noexcept { return count; }
+    size_t getBytes() const noexcept { return bytes; }
+
+    static void noteAllocation(size_t size) noexcept
+    {
+        if (ScopedAllocationCounter* c = current())
+        {
+            ++c->count;
+            c->bytes += size;
+        }
+    }
+
+private:
+    static ScopedAllocationCounter*& current() noexcept
+    {
+        thread_local ScopedAllocationCounter* c = nullptr;
+        return c;
+    }
+
+    int count = 0;
+    size_t bytes = 0;
+    ScopedAllocationCounter* previous;
+};
+
+/** set by --write-golden: the golden render tests write their files instead of checking against them. */
+inline bool& shouldWriteGolden()
+{
+    static bool write = false;
+    return write;
+}
+
+inline File goldenDirectory() { return File(BITTY_GOLDEN_DIR); }
+
+/** two channels of test signal, the same on every platform: built from integers only,
+    and every sample is k / 32768 for an int16 k, so the integer modes see the same
+    words however the conversion rounds. */
+inline AudioBuffer<float> makeSignal(int numSamples)
+{
+    AudioBuffer<float> b(2, numSamples);
+    uint32 lcg = 12345;
+
+    auto triangle = [] (int i, int period, int amplitude)
+    {
+        const int half = period / 2, phase = i % period;
+        return (phase < half ? phase : period - phase) * 2 * amplitude / half - amplitude;
+    };
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        lcg = lcg * 1664525u + 1013904223u;
+        const int noise = static_cast<int>(lcg >> 20) - 2048;
+
+        // a slow and a fast triangle on the left, noise over a slower one on the right
+        b.setSample(0, i, static_cast<float>(triangle(i, 1031, 16000) + triangle(i, 97, 6000)) / 32768.0f);
+        b.setSample(1, i, static_cast<float>(triangle(i, 4801, 20000) + noise) / 32768.0f);
+    }
+
+    return b;
+}
+
+/** writes buffer to file as a 32 bit float wav at sampleRate, replacing whatever was there. */
+inline bool writeWav(const File& file, const AudioBuffer<float>& buffer)
+{
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    std::unique_ptr<FileOutputStream> out(file.createOutputStream());
+    if (out == nullptr) return false;
+
+    // 32 bit wav is float, so nothing is lost
+    std::unique_ptr<AudioFormatWriter> writer(WavAudioFormat().createWriterFor(out.get(), sampleRate,
+                                                                               static_cast<unsigned int>(buffer.getNumChannels()), 32, {}, 0));
+    if (writer == nullptr) return false;
+    out.release();
+
+    return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+}
+
+/** entropy off, so the output is just the bit processing and the dc filter. */
+inline void prepare(BitmaskerEngine& e, int numChannels = 2)
+{
+    e.setEntropyVal(0);
+    e.setEntropyAmt(0);
+    e.prepareToPlay(numChannels, maxBlockSize, sampleRate);
+}
+
+/** runs buffer through e in place, taking block sizes from blockSizes in turn and handing
+    each block the part of midi that lands in it. returns how many allocations the engine
+    made inside processSamplesContextReplacing. */
+inline int render(BitmaskerEngine& e, AudioBuffer<float>& buffer, const std::vector<int>& blockSizes, const MidiBuffer& midi = MidiBuffer())
+{
+    MidiBuffer blockMidi;
+    int allocations = 0;
+    size_t next = 0;
+
+    for (int start = 0; start < buffer.getNumSamples();)
+    {
+        const int n = jmin(blockSizes[next++ % blockSizes.size()], buffer.getNumSamples() - start);
+        AudioBuffer<float> block(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, n);
+
+        blockMidi.clear();
+        blockMidi.addEvents(midi, start, n, -start);
+
+        {
+            ScopedAllocationCounter counter;
+            e.processSamplesContextReplacing(block, blockMidi);
+            allocations += counter.getCount();
+        }
+
+        start += n;
+    }
+
+    return allocations;
+}
+
+/** the quickest of rounds timings of f, in microseconds. the best rather than the
+    mean, so a context switch in one round doesn't move the number. */
+template <typename Function>
+double bestMicroseconds(int rounds, Function&& f)
+{
+    double best = std::numeric_limits<double>::max();
+
+    for (int i = 0; i < rounds; ++i)
+    {
+        const int64 start = Time::getHighResolutionTicks();
+        f();
+        best = jmin(best, Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1.0e6);
+    }
+
+    return best;
+}
+
+/** the first sample index where any channel differs by so much as a bit, or -1. */
+inline int firstDifference(const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+{
+    const int numChannels = jmin(a.getNumChannels(), b.getNumChannels());
+
+    for (int i = 0; i < jmin(a.getNumSamples(), b.getNumSamples()); ++i)
+        for (int chan = 0; chan < numChannels; ++chan)
+            if (std::memcmp(a.getReadPointer(chan, i), b.getReadPointer(chan, i), sizeof(float)) != 0)
+                return i;
+
+    return a.getNumSamples() == b.getNumSamples() ? -1 : jmin(a.getNumSamples(), b.getNumSamples());
+}
+
+} // namespace bittytest
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    TestMain.cpp
+    Created: 19 Oct 2026 10:44:52pm
+    Author:  Zachary Lewis-Towbes
+
+    bitty_tests: the unit tests, golden renders and benchmarks.
+
+        bitty_tests                         everything, exits non-zero on any failure
+        bitty_tests --category bitty        just the tests
+        bitty_tests --category benchmarks   just the benchmarks and their budgets
+        bitty_tests --category search       run the built bitty_search and load its presets
+        bitty_tests --write-golden          rewrite Tests/golden from this build
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#include "TestHelpers.h"
+
+#include <cstdlib>
+#include <new>
+
+
+//==============================================================================
+// counted allocations for ScopedAllocationCounter. the plain, array and nothrow
+// forms all go through malloc so every one pairs with the deletes below; nothing
+// bitty runs on the audio thread asks for over-aligned memory.
+void* operator new(std::size_t size)
+{
+    bittytest::ScopedAllocationCounter::noteAllocation(size);
+
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    bittytest::ScopedAllocationCounter::noteAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new[](std::size_t size, const std::nothrow_t& nt) noexcept { return operator new(size, nt); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    ArgumentList args(argc, argv);
+    bittytest::shouldWriteGolden() = args.containsOption("--write-golden");
+
+    UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (args.containsOption("--category")) runner.runTestsInCategory(args.getValueForOption("--category"));
+    else runner.runAllTests();
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult(i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    TransformTableTests.cpp
+    Created: 19 Oct 2026 10:53:40pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <bitset>
+#include <functional>
+
+#include "TestHelpers.h"
+
+
+/** every input word of every table checked against the transform done the slow
+    way on std::bitset, written from the description rather than from build(). */
+class TransformTableTests : public UnitTest
+{
+public:
+    TransformTableTests() : UnitTest("TransformTable", "bitty") {}
+
+    void runTest() override
+    {
+        using Reference = std::function<uint32(uint32)>;
+        constexpr uint32 mask = (1u << N_BITS) - 1;
+
+        // each expression next to what it should do to the unsigned word
+        const std::vector<std::pair<String, Reference>> expressions {
+            { "", [] (uint32 x) { return x; } },
+            { "~x", [] (uint32 x) { return ~x & mask; } },
+            { "rotl(x,3) ^ gray(x)", [] (uint32 x) { return (((x << 3) | (x >> (N_BITS - 3))) ^ x ^ (x >> 1)) & mask; } },
+            { "bitreverse(x) & 0x0FF0", [] (uint32 x)
+                {
+                    uint32 r = 0;
+                    for (int i = 0; i < N_BITS; ++i) r |= ((x >> i) & 1u) << (N_BITS - 1 - i);
+                    return r & 0x0FF0 & mask;
+                } },
+        };
+
+        Random r = getRandom();
+
+        for (const auto& e : expressions)
+        {
+            beginTest("every input, expression \"" + e.first + "\"");
+
+            BitExpression expr;
+            expect(expr.parse(e.first, N_BITS).wasOk(), e.first);
+
+            for (int config = 0; config < 12; ++config)
+            {
+                std::array<uint8, N_BITS> remap;
+                std::bitset<N_BITS> andmask, ormask, xormask;
+                makeConfig(config, r, remap, andmask, ormask, xormask);
+
+                auto table = TransformTable::build(expr, remap, andmask, ormask, xormask);
+
+                int wrong = 0, wrongProcessed = 0;
+                std::vector<BitWord> processed(TransformTable::size);
+                for (uint32 in = 0; in < static_cast<uint32>(TransformTable::size); ++in) processed[in] = static_cast<BitWord>(in);
+                table->process(processed.data(), TransformTable::size);
+
+                for (uint32 in = 0; in < static_cast<uint32>(TransformTable::size); ++in)
+                {
+                    const BitWord want = reference(e.second(in), remap, andmask, ormask, xormask);
+                    wrong += table->lut[in] != want;
+                    wrongProcessed += processed[in] != want;
+                }
+
+                expectEquals(wrong, 0, "lut, config " + String(config));
+                expectEquals(wrongProcessed, 0, "process(), config " + String(config) + (table->masksOnly ? " (masks only)" : ""));
+
+                // the plain masks are the fast path, so they'd better be found
+                if (e.first.isEmpty() && config < 3)
+                    expect(table->masksOnly, "config " + String(config) + " should run as plain masks");
+            }
+        }
+
+        beginTest("identity");
+        {
+            std::array<uint8, N_BITS> remap;
+            for (int i = 0; i < N_BITS; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+
+            auto identity = TransformTable::build(BitExpression(), remap, std::bitset<N_BITS>().set(), {}, {});
+            expect(identity->isIdentity());
+
+            auto flipped = TransformTable::build(BitExpression(), remap, std::bitset<N_BITS>().set(), {}, std::bitset<N_BITS>(1));
+            expect(! flipped->isIdentity());
+        }
+    }
+
+private:
+    /** the remap moves input bit idx to output bit remap[idx] in order, so later entries win
+        where two land on the same bit, and one past the top drops its bit. */
+    static BitWord reference(uint32 word, const std::array<uint8, N_BITS>& remap,
+                             std::bitset<N_BITS> andmask, std::bitset<N_BITS> ormask, std::bitset<N_BITS> xormask)
+    {
+        const std::bitset<N_BITS> in(word);
+        std::bitset<N_BITS> out;
+
+        for (size_t idx = 0; idx < N_BITS; ++idx)
+            if (remap[idx] < N_BITS)
+                out[remap[idx]] = in[idx];
+
+        return static_cast<BitWord>((((out & andmask) | ormask) ^ xormask).to_ulong());
+    }
+
+    /** a few hand-picked settings, then random ones including remaps with collisions and dropped bits. */
+    static void makeConfig(int config, Random& r, std::array<uint8, N_BITS>& remap,
+                               std::bitset<N_BITS>& andmask, std::bitset<N_BITS>& ormask, std::bitset<N_BITS>& xormask)
+    {
+        for (int i = 0; i < N_BITS; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(i);
+        andmask.set();
+        ormask.reset();
+        xormask.reset();
+
+        auto randomMask = [&r] { return std::bitset<N_BITS>(static_cast<unsigned long long>(r.nextInt(1 << N_BITS))); };
+
+        switch (config)
+        {
+            case 0: break;
+            case 1: xormask = randomMask(); break;
+            case 2: andmask = randomMask(); ormask = randomMask(); xormask = randomMask(); break;
+            case 3: for (int i = 0; i < N_BITS; ++i) remap[static_cast<size_t>(i)] = static_cast<uint8>(N_BITS - 1 - i); break;
+            case 4: std::fill(remap.begin(), remap.end(), static_cast<uint8>(3)); break;
+            case 5: remap[0] = N_BITS; remap[N_BITS - 1] = 0; break;
+            default:
+                for (auto& v : remap) v = static_cast<uint8>(r.nextInt(N_BITS + 1));
+                andmask = randomMask();
+                ormask = randomMask();
+                xormask = randomMask();
+                break;
+        }
+    }
+};
+
+static TransformTableTests transformTableTests;
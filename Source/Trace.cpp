@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    Trace.cpp
+    Created: 19 Oct 2026 8:05:13pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#include "Trace.h"
+
+
+namespace bittytrace
+{
+
+std::atomic<Tracer*> Tracer::active { nullptr };
+
+namespace
+{
+    // created on the first start() and deliberately kept until exit
+    std::unique_ptr<Tracer>& instance()
+    {
+        static std::unique_ptr<Tracer> t;
+        return t;
+    }
+
+    CriticalSection& startStopLock()
+    {
+        static CriticalSection cs;
+        return cs;
+    }
+}
+
+Tracer::Tracer() : Thread("bitty trace writer")
+{
+    microsPerTick = 1.0e6 / static_cast<double>(Time::getHighResolutionTicksPerSecond());
+}
+
+Tracer::~Tracer()
+{
+    stopThread(2000);
+}
+
+bool Tracer::start(const File& file)
+{
+    const ScopedLock sl(startStopLock());
+
+    if (active.load() != nullptr) return true;
+
+    auto& t = instance();
+    if (t == nullptr) t.reset(new Tracer());
+
+    file.deleteFile();
+    auto stream = std::make_unique<FileOutputStream>(file);
+    if (stream->failedToOpen()) return false;
+
+    // chrome's "JSON object" format; stop() writes the closing brackets
+    *stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    t->out = std::move(stream);
+    t->firstEvent = true;
+    t->originTicks = Time::getHighResolutionTicks();
+
+    // anything left over from a previous session is stale
+    for (auto& r : t->rings) r.drain([] (const Event&) {});
+    for (auto& r : t->rings) r.dropped.store(0);
+    t->ringless.store(0);
+
+    active.store(t.get());
+    t->startThread();
+    return true;
+}
+
+void Tracer::stop()
+{
+    const ScopedLock sl(startStopLock());
+
+    Tracer* t = active.exchange(nullptr);
+    if (t == nullptr) return;
+
+    t->stopThread(2000);
+    t->flush();
+
+    uint32 dropped = 0;
+    for (auto& r : t->rings) dropped += r.dropped.exchange(0);
+
+    // ringless: events from threads that arrived after the pool ran out
+    *t->out << "],\"otherData\":{\"droppedEvents\":" << String(static_cast<int64>(dropped))
+            << ",\"ringlessEvents\":" << String(static_cast<int64>(t->ringless.exchange(0))) << "}}\n";
+    t->out->flush();
+    t->out.reset();
+}
+
+void Tracer::record(const char* name, int64 startTicks, int64 endTicks) noexcept
+{
+    Tracer* t = active.load(std::memory_order_acquire);
+    if (t == nullptr) return;
+
+    if (EventRing* r = t->ringForThisThread())
+        r->push({ name, startTicks, endTicks });
+    else
+        t->ringless.fetch_add(1, std::memory_order_relaxed);
+}
+
+EventRing* Tracer::ringForThisThread() noexcept
+{
+    // plain pointer, so the thread_local needs no constructor and the first
+    // event on a new thread costs one atomic increment
+    thread_local EventRing* ring = nullptr;
+    thread_local bool claimed = false;
+
+    if (! claimed)
+    {
+        claimed = true;
+        const int idx = ringsClaimed.fetch_add(1);
+        ring = idx < maxThreads ? &rings[static_cast<size_t>(idx)] : nullptr;
+    }
+
+    return ring;
+}
+
+void Tracer::run()
+{
+    while (! threadShouldExit())
+    {
+        wait(100);
+        flush();
+    }
+}
+
+void Tracer::flush()
+{
+    if (out == nullptr) return;
+
+    const int numRings = jmin(ringsClaimed.load(), maxThreads);
+
+    for (int tid = 0; tid < numRings; ++tid)
+    {
+        rings[static_cast<size_t>(tid)].drain([this, tid] (const Event& e)
+        {
+            const double ts = static_cast<double>(e.start - originTicks) * microsPerTick;
+            const double dur = static_cast<double>(e.end - e.start) * microsPerTick;
+
+            *out << (firstEvent ? "" : ",")
+                 << "\n{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                 << ",\"ts\":" << String(ts, 3) << ",\"dur\":" << String(dur, 3) << "}";
+            firstEvent = false;
+        });
+    }
+
+    out->flush();
+}
+
+} // namespace bittytrace
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    Trace.h
+    Created: 19 Oct 2026 8:05:13pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+// build with -DBITTY_TRACING=ON (cmake) to get per-stage timings out of the
+// audio thread as a chrome://tracing / Perfetto json file. off, the macros
+// below compile to nothing.
+#ifndef BITTY_TRACING
+ #define BITTY_TRACING 0
+#endif
+
+
+namespace bittytrace
+{
+
+/** one completed stage, fixed size so the rings never allocate. name must be a string literal. */
+struct Event
+{
+    const char* name;
+    int64 start, end; // high resolution ticks
+};
+
+/**
+    Single producer / single consumer ring. Each thread that records events
+    claims one of these from a fixed pool on its first event, so recording is
+    a couple of relaxed loads and a release store, with no locks or allocation.
+    When the drain thread falls behind, events are dropped and counted; so are
+    events from threads that turned up after the pool was used up.
+*/
+class EventRing
+{
+public:
+    static constexpr int capacity = 1 << 14;
+
+    bool push(const Event& e) noexcept
+    {
+        const uint32 h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= static_cast<uint32>(capacity))
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        events[h & (capacity - 1)] = e;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename Fn>
+    void drain(Fn&& fn)
+    {
+        const uint32 h = head.load(std::memory_order_acquire);
+        uint32 t = tail.load(std::memory_order_relaxed);
+
+        for (; t != h; ++t) fn(events[t & (capacity - 1)]);
+
+        tail.store(t, std::memory_order_release);
+    }
+
+    std::atomic<uint32> dropped { 0 };
+
+private:
+    std::array<Event, capacity> events;
+    std::atomic<uint32> head { 0 }, tail { 0 };
+};
+
+
+/**
+    Owns the ring pool and a background thread that turns whatever the rings
+    hold into a Chrome trace event file every so often.
+
+    start() and stop() are for the message thread (or main() in the CLI).
+    The tracer lives until the process exits, so a callback that's mid-event
+    when tracing stops never touches freed memory.
+*/
+class Tracer : private Thread
+{
+public:
+    static constexpr int maxThreads = 16;
+
+    /** begins writing to file, replacing it. no-op if already tracing. */
+    static bool start(const File& file);
+    static void stop();
+
+    static bool isActive() noexcept { return active.load(std::memory_order_relaxed) != nullptr; }
+
+    /** audio thread. */
+    static void record(const char* name, int64 startTicks, int64 endTicks) noexcept;
+
+    ~Tracer() override;
+
+private:
+    Tracer();
+
+    void run() override;
+    void flush();
+
+    EventRing* ringForThisThread() noexcept;
+
+    static std::atomic<Tracer*> active;
+
+    std::array<EventRing, maxThreads> rings;
+    std::atomic<int> ringsClaimed { 0 };
+    std::atomic<uint32> ringless { 0 }; // recorded by threads that found the pool used up
+
+    std::unique_ptr<FileOutputStream> out;
+    bool firstEvent = true;
+    double microsPerTick = 0;
+    int64 originTicks = 0;
+};
+
+
+/** times its own scope and records it on the way out. */
+struct ScopedEvent
+{
+    explicit ScopedEvent(const char* n) noexcept
+        : name(n), start(Tracer::isActive() ? Time::getHighResolutionTicks() : 0) {}
+
+    ~ScopedEvent()
+    {
+        if (start != 0) Tracer::record(name, start, Time::getHighResolutionTicks());
+    }
+
+    const char* name;
+    int64 start;
+};
+
+} // namespace bittytrace
+
+
+#if BITTY_TRACING
+ #define BITTY_TRACE_CONCAT_(a, b) a ## b
+ #define BITTY_TRACE_CONCAT(a, b) BITTY_TRACE_CONCAT_(a, b)
+ #define BITTY_TRACE_SCOPE(name) const bittytrace::ScopedEvent BITTY_TRACE_CONCAT(bittyTraceScope_, __LINE__) (name)
+#else
+ #define BITTY_TRACE_SCOPE(name)
+#endif
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    TransformTable.h
+    Created: 19 Oct 2026 5:31:04pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <bitset>
+#include <memory>
+
+#include "BitExpression.h"
+
+
+#if N_BITS == 8
+using BitWord = uint8;
+#elif N_BITS == 16
+using BitWord = uint16;
+#endif
+
+
+/**
+    The whole per-sample transform (expression, remap and masks) baked down to
+    one lookup per sample. Immutable once built; the engine swaps whole tables.
+*/
+struct TransformTable
+{
+    static constexpr int size = 1 << N_BITS;
+
+    std::array<BitWord, size> lut;
+
+    // when the transform turns out to be plain ((x & and) | or) ^ xor, the
+    // audio thread runs that instead of the lookup, since it vectorises.
+    bool masksOnly = false;
+    BitWord andBits = 0, orBits = 0, xorBits = 0;
+
+    static std::unique_ptr<TransformTable> build(const BitExpression& expr,
+                                                 const std::array<uint8, N_BITS>& remap,
+                                                 std::bitset<N_BITS> andmask,
+                                                 std::bitset<N_BITS> ormask,
+                                                 std::bitset<N_BITS> xormask)
+    {
+        auto t = std::make_unique<TransformTable>();
+
+        const uint32 am = static_cast<uint32>(andmask.to_ulong());
+        const uint32 om = static_cast<uint32>(ormask.to_ulong());
+        const uint32 xm = static_cast<uint32>(xormask.to_ulong());
+
+        for (uint32 in = 0; in < static_cast<uint32>(size); ++in)
+        {
+            uint32 c = static_cast<uint32>(expr.evaluate(static_cast<int64>(in))) & (size - 1);
+            uint32 d = 0;
+
+            // same semantics as the old bitset loop, including later bits winning on collisions
+            for (uint8 idx = 0; idx < N_BITS; ++idx)
+            {
+                if (remap[idx] >= N_BITS) continue;
+                uint32 b = 1u << remap[idx];
+                d = (c >> idx) & 1 ? (d | b) : (d & ~b);
+            }
+
+            t->lut[in] = static_cast<BitWord>(((d & am) | om) ^ xm);
+        }
+
+        t->detectMasksOnly();
+        return t;
+    }
+
+    bool isIdentity() const noexcept
+    {
+        return masksOnly && andBits == static_cast<BitWord>(size - 1) && orBits == 0 && xorBits == 0;
+    }
+
+    /** in place, audio thread. */
+    void process(BitWord* data, int n) const noexcept
+    {
+        if (masksOnly)
+        {
+            const BitWord am = andBits, om = orBits, xm = xorBits;
+            for (int i = 0; i < n; ++i) data[i] = static_cast<BitWord>(((data[i] & am) | om) ^ xm);
+        }
+        else
+        {
+            const BitWord* l = lut.data();
+            for (int i = 0; i < n; ++i) data[i] = l[data[i]];
+        }
+    }
+
+private:
+    void detectMasksOnly()
+    {
+        // every output bit must be 0, 1, its own input bit or its inverse.
+        // reading that off the two extremes and checking the rest settles it.
+        const uint32 lo = lut.front(), hi = lut.back();
+        uint32 a = 0, o = 0, x = 0;
+
+        for (int bit = 0; bit < N_BITS; ++bit)
+        {
+            uint32 b = 1u << bit;
+            if ((lo & b) == (hi & b)) o |= lo & b;
+            else { a |= b; x |= lo & b; }
+        }
+
+        for (uint32 in = 0; in < static_cast<uint32>(size); ++in)
+            if (lut[in] != static_cast<BitWord>(((in & a) | o) ^ x)) return;
+
+        andBits = static_cast<BitWord>(a);
+        orBits = static_cast<BitWord>(o);
+        xorBits = static_cast<BitWord>(x);
+        masksOnly = true;
+    }
+};
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Created: 19 Oct 2026 4:52:30pm
+    Author:  Zachary Lewis-Towbes
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+
+/**
+    Hands owning pointers from one writer thread to the audio thread without
+    locks or allocation on the reading side.
+
+    The writer only ever touches its back slot, so whatever it replaces there
+    is guaranteed not to be in use by the reader and can be destroyed on the
+    spot. PtrType is anything with get() and move assignment (unique_ptr etc).
+*/
+template <typename PtrType>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    explicit TripleBuffer(PtrType initial) { slots[0] = std::move(initial); }
+
+    /** writer side. only one thread may publish at a time. */
+    void publish(PtrType p)
+    {
+        slots[static_cast<size_t>(back)] = std::move(p);
+        int old = middle.exchange(back | dirtyFlag, std::memory_order_acq_rel);
+        back = old & indexMask;
+    }
+
+    /** reader side (audio thread). picks up the latest publish, if any. */
+    auto acquire() noexcept
+    {
+        if (middle.load(std::memory_order_relaxed) & dirtyFlag)
+        {
+            int old = middle.exchange(front, std::memory_order_acq_rel);
+            front = old & indexMask;
+        }
+
+        return slots[static_cast<size_t>(front)].get();
+    }
+
+    /** reader side. whatever acquire() last returned. */
+    auto current() const noexcept { return slots[static_cast<size_t>(front)].get(); }
+
+private:
+    static constexpr int dirtyFlag = 4;
+    static constexpr int indexMask = 3;
+
+    std::array<PtrType, 3> slots;
+    int front = 0, back = 2;
+    std::atomic<int> middle { 1 };
+};